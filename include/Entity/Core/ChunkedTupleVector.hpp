@@ -0,0 +1,188 @@
+#ifndef CHUNKEDTUPLEVECTOR_HPP
+#define CHUNKEDTUPLEVECTOR_HPP
+
+#include <utility>
+#include "TupleVector.hpp"
+
+namespace Entity
+{
+
+// Columns of Types stored in blocks of BlockSize rows: each block holds all the columns of its rows,
+// laid out as a TupleVector of capacity BlockSize. Growing appends blocks, so elements never move
+// and their addresses stay valid until they are dropped by resize() or clear(). With Aligned
+// columns and a BlockSize multiple of the SIMD width, the columns of every block start on whole
+// aligned lanes (see forEachBlock).
+template <std::size_t BlockSize, class ... Types>
+class ChunkedTupleVector
+{
+    static_assert(BlockSize > 0, "A block must hold at least one row");
+    using Traits = TupleVectorTraits<sizeof...(Types), Types...>;
+public:
+    template <uint32_t offset>
+    using ColumnType = typename TupleVector<Types...>::template ColumnType<offset>;
+
+    ChunkedTupleVector() :
+        m_size(0)
+    {
+
+    }
+    explicit ChunkedTupleVector(std::size_t size) :
+        ChunkedTupleVector()
+    {
+        resize(size);
+    }
+    ChunkedTupleVector(const ChunkedTupleVector& other) :
+        ChunkedTupleVector()
+    {
+        reserve(other.capacity());
+        for(std::size_t block = 0; block < other.blocks(); ++block)
+        {
+            Traits::copy(other.m_blocks[block], BlockSize, m_blocks[block], BlockSize, other.blockRows(block));
+            m_size += other.blockRows(block);
+        }
+    }
+    ChunkedTupleVector(ChunkedTupleVector&& other) noexcept :
+        ChunkedTupleVector()
+    {
+        swap(*this, other);
+    }
+    ChunkedTupleVector& operator=(ChunkedTupleVector other)
+    {
+        swap(*this, other);
+        return *this;
+    }
+    ~ChunkedTupleVector()
+    {
+        resize(0);
+    }
+    friend void swap(ChunkedTupleVector& first, ChunkedTupleVector& second)
+    {
+        using std::swap;
+        swap(first.m_size, second.m_size);
+        first.m_storage.swap(second.m_storage);
+        first.m_blocks.swap(second.m_blocks);
+    }
+    static constexpr std::size_t blockSize()
+    {
+        return BlockSize;
+    }
+    std::size_t size() const
+    {
+        return m_size;
+    }
+    bool empty() const
+    {
+        return size() == 0;
+    }
+    std::size_t capacity() const
+    {
+        return m_blocks.size()*BlockSize;
+    }
+    // Number of blocks holding rows.
+    std::size_t blocks() const
+    {
+        return integerCeilDivision(m_size, BlockSize);
+    }
+    // Number of rows in block, BlockSize but for the last one.
+    std::size_t blockRows(std::size_t block) const
+    {
+        return std::min(BlockSize, m_size - block*BlockSize);
+    }
+    void reserve(std::size_t newCapacity)
+    {
+        const std::size_t newBlocks = integerCeilDivision(newCapacity, BlockSize);
+        if(newBlocks <= m_blocks.size())
+        {
+            return;
+        }
+        m_storage.reserve(newBlocks);
+        m_blocks.reserve(newBlocks);
+        while(m_blocks.size() < newBlocks)
+        {
+            unsigned char* data;
+            m_storage.push_back(allocateAligned(Traits::bytesNeeded(BlockSize), Traits::alignment(), data));
+            m_blocks.push_back(data);
+        }
+    }
+    // Value-initializes the new rows, so trivial columns read zero, or destroys the dropped ones.
+    void resize(std::size_t newSize)
+    {
+        reserve(newSize);
+        while(m_size < newSize)
+        {
+            const std::size_t block = m_size / BlockSize;
+            const std::size_t last  = std::min(newSize, (block + 1)*BlockSize);
+            Traits::construct(m_blocks[block], BlockSize, m_size - block*BlockSize, last - block*BlockSize);
+            m_size = last;
+        }
+        while(m_size > newSize)
+        {
+            const std::size_t block = (m_size - 1) / BlockSize;
+            const std::size_t first = std::max(newSize, block*BlockSize);
+            Traits::destroy(m_blocks[block], BlockSize, first - block*BlockSize, m_size - block*BlockSize);
+            m_size = first;
+        }
+    }
+    void clear()
+    {
+        ChunkedTupleVector other;
+        swap(*this, other);
+    }
+    template <uint32_t offset>
+    void set(std::size_t index, ColumnType<offset> value)
+    {
+        blockColumn<offset>(index / BlockSize)[index % BlockSize] = std::move(value);
+    }
+    template <uint32_t offset>
+    ColumnType<offset>& at(std::size_t index)
+    {
+        return blockColumn<offset>(index / BlockSize)[index % BlockSize];
+    }
+    template <uint32_t offset>
+    const ColumnType<offset>& at(std::size_t index) const
+    {
+        return blockColumn<offset>(index / BlockSize)[index % BlockSize];
+    }
+    // First of the BlockSize elements of a column in block.
+    template <uint32_t offset>
+    ColumnType<offset>* blockColumn(std::size_t block)
+    {
+        return TupleVectorTraits<offset+1, Types...>::column(m_blocks[block], BlockSize);
+    }
+    template <uint32_t offset>
+    const ColumnType<offset>* blockColumn(std::size_t block) const
+    {
+        return TupleVectorTraits<offset+1, Types...>::column(static_cast<const unsigned char*>(m_blocks[block]), BlockSize);
+    }
+    // Calls callable(first, rows, column0, column1, ...) for every block holding rows, where first
+    // is the index of its first row and each column points to the elements of the block.
+    template <class Callable>
+    void forEachBlock(Callable callable)
+    {
+        forEachBlock(*this, callable, std::make_index_sequence<sizeof...(Types)>{});
+    }
+    template <class Callable>
+    void forEachBlock(Callable callable) const
+    {
+        forEachBlock(*this, callable, std::make_index_sequence<sizeof...(Types)>{});
+    }
+
+private:
+    template <class Self, class Callable, std::size_t ... Offsets>
+    static void forEachBlock(Self& self, Callable& callable, std::index_sequence<Offsets...>)
+    {
+        const std::size_t blocks = self.blocks();
+        for(std::size_t block = 0; block < blocks; ++block)
+        {
+            callable(block*BlockSize, self.blockRows(block), self.template blockColumn<Offsets>(block)...);
+        }
+    }
+
+    std::size_t                                   m_size;
+    std::vector<std::unique_ptr<unsigned char[]>> m_storage;
+    std::vector<unsigned char*>                   m_blocks;
+};
+
+}
+
+#endif // CHUNKEDTUPLEVECTOR_HPP
@@ -3,6 +3,9 @@
 
 #include "Property.hpp"
 #include "SystemWithDeletion.hpp"
+#include <algorithm>
+#include <array>
+#include <functional>
 #include <type_traits>
 
 namespace Entity
@@ -12,6 +15,11 @@ namespace Entity
 struct Right {};
 struct Left  {};
 struct Both  {};
+// Left with backward sibling links, for O(1) removeChild.
+struct DoublyLinkedLeft {};
+// Left with the children of each parent in a small vector of N inline slots.
+template <std::size_t N = 4>
+struct SmallLeft {};
 
 // Mapping types
 
@@ -23,6 +31,10 @@ public:
     NonMapped(ParentSystemType<ParentType>&, ChildSystemType<ChildType>&)
     {
 
+    }
+    NonMapped(const NonMapped&, ParentSystemType<ParentType>&, ChildSystemType<ChildType>&)
+    {
+
     }
 };
 
@@ -35,6 +47,11 @@ public:
         m_parent(makeProperty<ParentType>(child))
     {
 
+    }
+    RightMapped(const RightMapped& other, ParentSystemType<ParentType>&, ChildSystemType<ChildType>& child):
+        m_parent(other.m_parent, child)
+    {
+
     }
     ParentType parent(ChildType child) const
     {
@@ -48,6 +65,22 @@ public:
     {
         m_parent[child] = parent;
     }
+    template <class RangeType>
+    void addChildren(ParentType parent, const RangeType& children)
+    {
+        for(ChildType child : children)
+        {
+            m_parent[child] = parent;
+        }
+    }
+    template <class RangeType>
+    void buildFrom(const RangeType& pairs)
+    {
+        for(const auto& pair : pairs)
+        {
+            m_parent[pair.second] = pair.first;
+        }
+    }
     void removeChild(ParentType parent, ChildType child)
     {
         if(this->parent(child) == parent)
@@ -61,36 +94,164 @@ protected:
 
 // SFINAE to connect the signal for erasing child entity >
 template <typename ParentType, template <typename> class ParentSystemType, typename ChildType, template <typename> class ChildSystemType>
-auto connectOnEraseIfPossibleForLeftMapped(int, boost::signals2::scoped_connection& connection, std::shared_ptr<typename ParentSystemType<ParentType>::Notifier>& notifier, ChildSystemType<ChildType>& child, Property<ParentType, ChildType, ParentSystemType>& firstChild, Property<ChildType, ChildType, ChildSystemType>& nextSibling) -> decltype((void)&ChildSystemType<ChildType>::erase, void())
+auto connectOnEraseIfPossibleForLeftMapped(int, boost::signals2::scoped_connection& connection, boost::signals2::scoped_connection& manyConnection, std::shared_ptr<typename ParentSystemType<ParentType>::Notifier>& notifier, ChildSystemType<ChildType>& child, Property<ParentType, ChildType, ParentSystemType>& firstChild, Property<ChildType, ChildType, ChildSystemType>& nextSibling) -> decltype((void)&ChildSystemType<ChildType>::erase, void())
 {
-    connection = std::move(notifier->onErase.connect([&](ParentType en)
+    // The children of all the erased parents are collected first and erased at once, so a whole
+    // subtree goes down with one bulk erase per level. The slots go in front of the other
+    // listeners of the parent system, e.g. childrenSize, which must still index the erased parents
+    // while the children unlink themselves from them. If the children are in the parent system,
+    // the system defers their erase until the parents are compacted (see SystemWithDeletion::erase).
+    auto onEraseMany = [&](const std::vector<ParentType>& entities)
     {
-        for(ChildType curr{firstChild[en]}, next; curr != ChildType{}; curr = next)
+        std::vector<ChildType> children;
+        for(ParentType en : entities)
         {
-            next = nextSibling[curr];
-            child.erase(curr);
+            for(ChildType curr{firstChild[en]}; curr != ChildType{}; curr = nextSibling[curr])
+            {
+                children.push_back(curr);
+            }
         }
-        firstChild.onErase(en);
-    }));
+        child.eraseMany(children);
+        firstChild.onEraseMany(entities);
+    };
+    connection = std::move(notifier->onErase.connect([onEraseMany](ParentType en)
+    {
+        onEraseMany({en});
+    }, boost::signals2::at_front));
+    manyConnection = std::move(notifier->onEraseMany.connect(onEraseMany, boost::signals2::at_front));
 }
 
 template <typename ParentType, template <typename> class ParentSystemType, typename ChildType, template <typename> class ChildSystemType>
-auto connectOnEraseIfPossibleForLeftMapped(char, boost::signals2::scoped_connection&, std::shared_ptr<typename ParentSystemType<ParentType>::Notifier>&, ChildSystemType<ChildType>&, Property<ParentType, ChildType, ParentSystemType>&, Property<ChildType, ChildType, ChildSystemType>&) -> decltype(void(), void())
+auto connectOnEraseIfPossibleForLeftMapped(char, boost::signals2::scoped_connection&, boost::signals2::scoped_connection&, std::shared_ptr<typename ParentSystemType<ParentType>::Notifier>&, ChildSystemType<ChildType>&, Property<ParentType, ChildType, ParentSystemType>&, Property<ChildType, ChildType, ChildSystemType>&) -> decltype(void(), void())
 {}
 // <
 
+// Optional backward links of the sibling lists >
+template <bool Enabled, typename ChildType, template <typename> class ChildSystemType>
+class PrevSiblings
+{
+public:
+    PrevSiblings(ChildSystemType<ChildType>& child):
+        m_prevSibling(makeProperty<ChildType>(child))
+    {
+
+    }
+    PrevSiblings(const PrevSiblings& other, ChildSystemType<ChildType>& child):
+        m_prevSibling(other.m_prevSibling, child)
+    {
+
+    }
+    static constexpr bool enabled()
+    {
+        return true;
+    }
+    ChildType get(ChildType child) const
+    {
+        return m_prevSibling[child];
+    }
+    void set(ChildType child, ChildType prev)
+    {
+        m_prevSibling[child] = prev;
+    }
+    void disconnectOnErase()
+    {
+        m_prevSibling.disconnectOnErase();
+    }
+    void onErase(ChildType child)
+    {
+        m_prevSibling.onErase(child);
+    }
+    void onEraseMany(const std::vector<ChildType>& children)
+    {
+        m_prevSibling.onEraseMany(children);
+    }
+private:
+    Property<ChildType, ChildType, ChildSystemType> m_prevSibling;
+};
+
+template <typename ChildType, template <typename> class ChildSystemType>
+class PrevSiblings<false, ChildType, ChildSystemType>
+{
+public:
+    PrevSiblings(ChildSystemType<ChildType>&)
+    {
+
+    }
+    PrevSiblings(const PrevSiblings&, ChildSystemType<ChildType>&)
+    {
+
+    }
+    static constexpr bool enabled()
+    {
+        return false;
+    }
+    ChildType get(ChildType) const
+    {
+        return ChildType{};
+    }
+    void set(ChildType, ChildType)
+    {
+
+    }
+    void disconnectOnErase()
+    {
+
+    }
+    void onErase(ChildType)
+    {
+
+    }
+    void onEraseMany(const std::vector<ChildType>&)
+    {
+
+    }
+};
+// <
+
 // A composition should inherit Left Mapped when it is necessary O(1) mapping from parent to children.
-template <typename ParentType, template <typename> class ParentSystemType, typename ChildType, template <typename> class ChildSystemType>
+// The children of a parent are a linked list through m_nextSibling. A composition that is built once
+// and then mostly read can be frozen: the lists are copied parent by parent into one contiguous
+// array (compressed sparse rows), and children() then walks an array instead of chasing siblings.
+// Any change to the composition, or erasing a parent or a child, thaws it back to the lists. In
+// auto freeze mode, children() freezes the composition again once it has been called as many times
+// as there are parents since the last change, so a rebuild never costs more than the reads it speeds
+// up. That makes children() modify the composition, so concurrent readers must freeze it beforehand.
+// With DoublyLinked, every child also points back to its previous sibling, so removeChild does not
+// have to walk the list from the first child to find it.
+template <typename ParentType, template <typename> class ParentSystemType, typename ChildType, template <typename> class ChildSystemType, bool DoublyLinked = false>
 class LeftMapped
 {
 public:
     LeftMapped(ParentSystemType<ParentType>& parent, ChildSystemType<ChildType>& child):
         m_childrenSize(makeProperty<std::size_t>(parent)),
         m_firstChild(makeProperty<ChildType>(parent)),
-        m_nextSibling(makeProperty<ChildType>(child))
+        m_nextSibling(makeProperty<ChildType>(child)),
+        m_prevSibling(child),
+        m_frozenBegin(makeProperty<std::size_t>(parent)),
+        m_frozen(false),
+        m_autoFreeze(false),
+        m_reads(0),
+        m_version(0)
     {
         m_firstChild.disconnectOnErase();
-        connectOnEraseIfPossibleForLeftMapped(0, m_onEraseConnection, parent.notifier, child, m_firstChild, m_nextSibling);
+        connectOnEraseIfPossibleForLeftMapped(0, m_onEraseConnection, m_onEraseManyConnection, parent.notifier, child, m_firstChild, m_nextSibling);
+        connectThawSignals(parent, child);
+    }
+    LeftMapped(const LeftMapped& other, ParentSystemType<ParentType>& parent, ChildSystemType<ChildType>& child):
+        m_childrenSize(other.m_childrenSize, parent),
+        m_firstChild(other.m_firstChild, parent),
+        m_nextSibling(other.m_nextSibling, child),
+        m_prevSibling(other.m_prevSibling, child),
+        m_frozenBegin(other.m_frozenBegin, parent),
+        m_frozenChildren(other.m_frozenChildren),
+        m_frozen(other.m_frozen),
+        m_autoFreeze(other.m_autoFreeze),
+        m_reads(other.m_reads),
+        m_version(other.m_version)
+    {
+        m_firstChild.disconnectOnErase();
+        connectOnEraseIfPossibleForLeftMapped(0, m_onEraseConnection, m_onEraseManyConnection, parent.notifier, child, m_firstChild, m_nextSibling);
+        connectThawSignals(parent, child);
     }
     ChildType firstChild(ParentType parent) const
     {
@@ -100,20 +261,123 @@ public:
     {
         return m_nextSibling[child];
     }
+    template <bool Enabled = DoublyLinked, typename = std::enable_if_t<Enabled>>
+    ChildType prevSibling(ChildType child) const
+    {
+        return m_prevSibling.get(child);
+    }
     void firstChild(ParentType parent, ChildType child)
     {
+        thaw();
         m_firstChild[parent] = child;
+        if(child != ChildType{})
+        {
+            m_prevSibling.set(child, ChildType{});
+        }
     }
     void nextSibling(ChildType child, ChildType next)
     {
+        thaw();
         m_nextSibling[child] = next;
+        if(next != ChildType{})
+        {
+            m_prevSibling.set(next, child);
+        }
     }
     void addChild(ParentType parent, ChildType child)
     {
+        thaw();
         ++m_childrenSize[parent];
-        m_nextSibling[child] = m_firstChild[parent];
+        const ChildType first = m_firstChild[parent];
+        m_nextSibling[child] = first;
+        m_prevSibling.set(child, ChildType{});
+        if(first != ChildType{})
+        {
+            m_prevSibling.set(first, child);
+        }
         m_firstChild[parent] = child;
     }
+    // Same as calling addChild for each child, but the parent is looked up once.
+    template <class RangeType>
+    void addChildren(ParentType parent, const RangeType& children)
+    {
+        thaw();
+        std::size_t added = 0;
+        ChildType first = m_firstChild[parent];
+        for(ChildType child : children)
+        {
+            m_nextSibling[child] = first;
+            m_prevSibling.set(child, ChildType{});
+            if(first != ChildType{})
+            {
+                m_prevSibling.set(first, child);
+            }
+            first = child;
+            ++added;
+        }
+        m_firstChild[parent] = first;
+        m_childrenSize[parent] += added;
+    }
+    // Same as calling addChild for each (parent, child) pair, in one counting sort: the children are
+    // counted per parent, placed into the contiguous array of a frozen composition, and the sibling
+    // lists are then linked in one sweep over it. The composition is left frozen.
+    template <class RangeType>
+    void buildFrom(const RangeType& pairs)
+    {
+        // Keep the current number of children of each parent aside, and count the new ones.
+        std::size_t total = 0;
+        {
+            auto begin = m_frozenBegin.asRange().begin();
+            for(std::size_t size : m_childrenSize.asRange())
+            {
+                *begin++ = size;
+                total += size;
+            }
+        }
+        for(const auto& pair : pairs)
+        {
+            ++m_childrenSize[pair.first];
+            ++total;
+        }
+        // The new children go first, the current ones after them in their current order.
+        m_frozenChildren.resize(total);
+        {
+            std::size_t offset = 0;
+            auto begin = m_frozenBegin.asRange().begin();
+            auto first = m_firstChild.asRange().begin();
+            for(std::size_t size : m_childrenSize.asRange())
+            {
+                std::size_t position = offset + size - *begin;
+                *begin++ = position;
+                for(ChildType child = *first++; child != ChildType{}; child = m_nextSibling[child])
+                {
+                    m_frozenChildren[position++] = child;
+                }
+                offset += size;
+            }
+        }
+        for(const auto& pair : pairs)
+        {
+            m_frozenChildren[--m_frozenBegin[pair.first]] = pair.second;
+        }
+        {
+            auto begin = m_frozenBegin.asRange().begin();
+            auto first = m_firstChild.asRange().begin();
+            for(std::size_t size : m_childrenSize.asRange())
+            {
+                const ChildType* children = m_frozenChildren.data() + *begin++;
+                *first++ = size > 0 ? children[0] : ChildType{};
+                for(std::size_t index = 0; index < size; ++index)
+                {
+                    m_nextSibling[children[index]] = index + 1 < size ? children[index + 1] : ChildType{};
+                    m_prevSibling.set(children[index], index > 0 ? children[index - 1] : ChildType{});
+                }
+            }
+        }
+        m_frozen = true;
+        m_reads = 0;
+        ++m_version;
+    }
     std::size_t childrenSize(ParentType parent) const
     {
         return m_childrenSize[parent];
@@ -121,11 +385,56 @@ public:
     void disconnectOnErase()
     {
         m_onEraseConnection.disconnect();
+        m_onEraseManyConnection.disconnect();
+    }
+    // Copies the children of every parent into one contiguous array, keeping their order.
+    void freeze()
+    {
+        rebuild();
+    }
+    void thaw()
+    {
+        m_frozen = false;
+        m_reads = 0;
+        ++m_version;
+    }
+    // Changes whenever the sibling lists may have changed, so derived data (e.g. an EulerTourIndex)
+    // can tell when it is stale.
+    std::size_t version() const
+    {
+        return m_version;
+    }
+    bool frozen() const
+    {
+        return m_frozen;
+    }
+    void autoFreeze(bool enabled)
+    {
+        m_autoFreeze = enabled;
+        m_reads = 0;
     }
     void removeChild(ParentType parent, ChildType child)
     {
+        thaw();
         --this->m_childrenSize[parent];
-        if(child == this->firstChild(parent))
+        if(m_prevSibling.enabled())
+        {
+            const ChildType prev = m_prevSibling.get(child);
+            const ChildType next = m_nextSibling[child];
+            if(prev != ChildType{})
+            {
+                m_nextSibling[prev] = next;
+            }
+            else if(child == m_firstChild[parent])
+            {
+                m_firstChild[parent] = next;
+            }
+            if(next != ChildType{})
+            {
+                m_prevSibling.set(next, prev);
+            }
+        }
+        else if(child == this->firstChild(parent))
         {
             this->firstChild(parent, this->nextSibling(child));
         }
@@ -144,12 +453,16 @@ public:
             }
         }
     }
+    // Walks the sibling list, or the contiguous children of the parent if the composition is frozen.
     class ChildrenView
       : public ranges::view_facade<ChildrenView> {
     private:
         friend ranges::range_access;
         const LeftMapped* m_mapped;
         ranges::semiregular_t<ChildType> m_current;
+        const ChildType* m_next = nullptr;
+        const ChildType* m_end  = nullptr;
+        bool m_contiguous = false;
         struct cursor
         {
         private:
@@ -178,7 +491,14 @@ public:
         };
         void next()
         {
-            m_current = m_mapped->nextSibling(m_current);
+            if(m_contiguous)
+            {
+                m_current = m_next == m_end ? ChildType{} : *m_next++;
+            }
+            else
+            {
+                m_current = m_mapped->nextSibling(m_current);
+            }
         }
         cursor begin_cursor()
         {
@@ -188,8 +508,16 @@ public:
         ChildrenView() = default;
         ChildrenView(const LeftMapped& mapped, ParentType parent)
             : m_mapped(&mapped),
-              m_current(mapped.firstChild(parent))
-        { }
+              m_current(mapped.firstChild(parent)),
+              m_contiguous(mapped.m_frozen)
+        {
+            if(m_contiguous)
+            {
+                m_next = mapped.m_frozenChildren.data() + mapped.m_frozenBegin[parent];
+                m_end  = m_next + mapped.m_childrenSize[parent];
+                next();
+            }
+        }
         ChildType& current()
         {
             return m_current;
@@ -198,78 +526,378 @@ public:
 
     auto children(ParentType parent) const
     {
+        if(m_autoFreeze && !m_frozen && ++m_reads >= m_firstChild.size())
+        {
+            rebuild();
+        }
         return ChildrenView(*this, parent);
     }
+private:
+    void rebuild() const
+    {
+        m_frozenChildren.clear();
+        auto begin = m_frozenBegin.asRange().begin();
+        for(ChildType first : m_firstChild.asRange())
+        {
+            *begin++ = m_frozenChildren.size();
+            for(ChildType child = first; child != ChildType{}; child = m_nextSibling[child])
+            {
+                m_frozenChildren.push_back(child);
+            }
+        }
+        m_frozen = true;
+    }
+    void connectThawSignals(ParentSystemType<ParentType>& parent, ChildSystemType<ChildType>& child)
+    {
+        m_thawConnections[0] = std::move(parent.notifier->onErase.connect([this](ParentType)
+        {
+            thaw();
+        }));
+        m_thawConnections[1] = std::move(parent.notifier->onEraseMany.connect([this](const std::vector<ParentType>&)
+        {
+            thaw();
+        }));
+        m_thawConnections[2] = std::move(child.notifier->onErase.connect([this](ChildType)
+        {
+            thaw();
+        }));
+        m_thawConnections[3] = std::move(child.notifier->onEraseMany.connect([this](const std::vector<ChildType>&)
+        {
+            thaw();
+        }));
+    }
 protected:
     boost::signals2::scoped_connection m_onEraseConnection;
+    boost::signals2::scoped_connection m_onEraseManyConnection;
     Property<ParentType, std::size_t, ParentSystemType> m_childrenSize;
     Property<ParentType, ChildType, ParentSystemType> m_firstChild;
     Property<ChildType, ChildType, ChildSystemType> m_nextSibling;
+    PrevSiblings<DoublyLinked, ChildType, ChildSystemType> m_prevSibling;
+private:
+    // Start of the children of each parent in m_frozenChildren, valid while frozen.
+    mutable Property<ParentType, std::size_t, ParentSystemType> m_frozenBegin;
+    mutable std::vector<ChildType> m_frozenChildren;
+    mutable bool m_frozen;
+    bool m_autoFreeze;
+    mutable std::size_t m_reads;
+    std::size_t m_version;
+    std::array<boost::signals2::scoped_connection, 4> m_thawConnections;
 };
 
 // SFINAE to connect the signal for erasing child entity >
 template <typename ParentType, template <typename> class ParentSystemType, typename ChildType, template <typename> class ChildSystemType>
-auto connectOnEraseIfPossibleForBothMapped(int, boost::signals2::scoped_connection& connection, std::shared_ptr<typename ParentSystemType<ParentType>::Notifier>& notifier, ChildSystemType<ChildType>& child, Property<ParentType, ChildType, ParentSystemType>& firstChild, Property<ChildType, ChildType, ChildSystemType>& nextSibling, Property<ChildType, ParentType, ChildSystemType>& parent) -> decltype((void)&ChildSystemType<ChildType>::erase, void())
+auto connectOnEraseIfPossibleForBothMapped(int, boost::signals2::scoped_connection& connection, boost::signals2::scoped_connection& manyConnection, std::shared_ptr<typename ParentSystemType<ParentType>::Notifier>& notifier, ChildSystemType<ChildType>& child, Property<ParentType, ChildType, ParentSystemType>& firstChild, Property<ChildType, ChildType, ChildSystemType>& nextSibling, Property<ChildType, ParentType, ChildSystemType>& parent) -> decltype((void)&ChildSystemType<ChildType>::erase, void())
 {
-    connectOnEraseIfPossibleForLeftMapped(0, connection, notifier, child, firstChild, nextSibling);
+    connectOnEraseIfPossibleForLeftMapped(0, connection, manyConnection, notifier, child, firstChild, nextSibling);
 }
 
 template <typename ParentType, template <typename> class ParentSystemType, typename ChildType, template <typename> class ChildSystemType>
-auto connectOnEraseIfPossibleForBothMapped(char, boost::signals2::scoped_connection& connection, std::shared_ptr<typename ParentSystemType<ParentType>::Notifier>& notifier, ChildSystemType<ChildType>& child, Property<ParentType, ChildType, ParentSystemType>& firstChild, Property<ChildType, ChildType, ChildSystemType>& nextSibling, Property<ChildType, ParentType, ChildSystemType>& parent) -> decltype(void(), void())
+auto connectOnEraseIfPossibleForBothMapped(char, boost::signals2::scoped_connection& connection, boost::signals2::scoped_connection& manyConnection, std::shared_ptr<typename ParentSystemType<ParentType>::Notifier>& notifier, ChildSystemType<ChildType>& child, Property<ParentType, ChildType, ParentSystemType>& firstChild, Property<ChildType, ChildType, ChildSystemType>& nextSibling, Property<ChildType, ParentType, ChildSystemType>& parent) -> decltype(void(), void())
 {
-    connection = std::move(notifier->onErase.connect([&](ParentType en)
+    auto onEraseMany = [&](const std::vector<ParentType>& entities)
     {
-        for(ChildType curr{firstChild[en]}, next; curr != ChildType{}; curr = next)
+        for(ParentType en : entities)
         {
-            next = nextSibling[curr];
-            parent[curr] = ParentType{};
+            for(ChildType curr{firstChild[en]}; curr != ChildType{}; curr = nextSibling[curr])
+            {
+                parent[curr] = ParentType{};
+            }
         }
-        firstChild.onErase(en);
-    }));
+        firstChild.onEraseMany(entities);
+    };
+    connection = std::move(notifier->onErase.connect([onEraseMany](ParentType en)
+    {
+        onEraseMany({en});
+    }, boost::signals2::at_front));
+    manyConnection = std::move(notifier->onEraseMany.connect(onEraseMany, boost::signals2::at_front));
 }
 // <
 
-// BothMapped is a wrap for both Left and Right Mappings.
+// BothMapped is a wrap for both Left and Right Mappings. Its sibling lists are doubly linked, so
+// erasing a child unlinks it in O(1).
 template <typename ParentType, template <typename> class ParentSystemType, typename ChildType, template <typename> class ChildSystemType>
-class BothMapped: public LeftMapped<ParentType, ParentSystemType, ChildType, ChildSystemType>, public RightMapped<ParentType, ParentSystemType, ChildType, ChildSystemType>
+class BothMapped: public LeftMapped<ParentType, ParentSystemType, ChildType, ChildSystemType, true>, public RightMapped<ParentType, ParentSystemType, ChildType, ChildSystemType>
 {
-    using LeftParent = LeftMapped<ParentType, ParentSystemType, ChildType, ChildSystemType>;
+    using LeftParent = LeftMapped<ParentType, ParentSystemType, ChildType, ChildSystemType, true>;
     using RightParent = RightMapped<ParentType, ParentSystemType, ChildType, ChildSystemType>;
 public:
     BothMapped(ParentSystemType<ParentType>& parent, ChildSystemType<ChildType>& child):
         LeftParent(parent, child),
         RightParent(parent, child)
+    {
+        connectSignals(parent, child);
+    }
+    BothMapped(const BothMapped& other, ParentSystemType<ParentType>& parent, ChildSystemType<ChildType>& child):
+        LeftParent(other, parent, child),
+        RightParent(other, parent, child)
+    {
+        connectSignals(parent, child);
+    }
+    void addChild(ParentType parent, ChildType child)
+    {
+       LeftParent::addChild(parent, child);
+       RightParent::addChild(parent, child);
+    }
+    template <class RangeType>
+    void addChildren(ParentType parent, const RangeType& children)
+    {
+        LeftParent::addChildren(parent, children);
+        RightParent::addChildren(parent, children);
+    }
+    template <class RangeType>
+    void buildFrom(const RangeType& pairs)
+    {
+        LeftParent::buildFrom(pairs);
+        RightParent::buildFrom(pairs);
+    }
+    void removeChild(ParentType parent, ChildType child)
+    {
+        RightParent::removeChild(parent, child);
+        LeftParent::removeChild(parent, child);
+    }
+
+private:
+    void connectSignals(ParentSystemType<ParentType>& parent, ChildSystemType<ChildType>& child)
     {
         LeftParent::disconnectOnErase();
         {
-            connectOnEraseIfPossibleForBothMapped(0, this->m_onEraseConnection, parent.notifier, child, this->m_firstChild, this->m_nextSibling, this->m_parent);
+            connectOnEraseIfPossibleForBothMapped(0, this->m_onEraseConnection, this->m_onEraseManyConnection, parent.notifier, child, this->m_firstChild, this->m_nextSibling, this->m_parent);
         }
         this->m_nextSibling.disconnectOnErase();
+        this->m_prevSibling.disconnectOnErase();
         this->m_parent.disconnectOnErase();
-        m_onEraseChildConnection = std::move(child.notifier->onErase.connect([&](ChildType child)
+        auto unlink = [&](ChildType child)
         {
             auto theParent = this->parent(child);
             if(parent.alive(theParent))
             {
                removeChild(theParent, child);
             }
+        };
+        m_onEraseChildConnection     = std::move(child.notifier->onErase.connect([this, unlink](ChildType child)
+        {
+            unlink(child);
             this->m_nextSibling.onErase(child);
+            this->m_prevSibling.onErase(child);
             this->m_parent.onErase(child);
         }));
+        // Unlinking writes the links of the siblings, so all the children are unlinked before the
+        // columns are compacted.
+        m_onEraseManyChildConnection = std::move(child.notifier->onEraseMany.connect([this, unlink](const std::vector<ChildType>& children)
+        {
+            for(ChildType child : children)
+            {
+                unlink(child);
+            }
+            this->m_nextSibling.onEraseMany(children);
+            this->m_prevSibling.onEraseMany(children);
+            this->m_parent.onEraseMany(children);
+        }));
+    }
+
+    boost::signals2::scoped_connection m_onEraseChildConnection;
+    boost::signals2::scoped_connection m_onEraseManyChildConnection;
+};
+
+// SFINAE to erase the children of an erased parent >
+template <typename ChildType, template <typename> class ChildSystemType, class RangeType>
+auto eraseChildrenIfPossible(int, ChildSystemType<ChildType>& child, const RangeType& children) -> decltype((void)&ChildSystemType<ChildType>::erase, void())
+{
+    child.eraseMany(children);
+}
+
+template <typename ChildType, template <typename> class ChildSystemType, class RangeType>
+auto eraseChildrenIfPossible(char, ChildSystemType<ChildType>&, const RangeType&) -> decltype(void(), void())
+{}
+// <
+
+// A composition should inherit Small Left Mapped when parents have few children each, e.g. the pins
+// of a cell. The first N children of a parent are stored in the parent itself, and the others spill
+// over to blocks of an arena shared by all parents, which double in size as they fill. Children are
+// contiguous and kept in the order they were added, and addChild is O(1) amortized. Blocks left
+// behind by growing or erased parents are reclaimed once they are half of the arena.
+template <typename ParentType, template <typename> class ParentSystemType, typename ChildType, template <typename> class ChildSystemType, std::size_t N>
+class SmallLeftMapped
+{
+    static_assert(N > 0, "SmallLeftMapped needs at least one inline slot");
+public:
+    SmallLeftMapped(ParentSystemType<ParentType>& parent, ChildSystemType<ChildType>& child):
+        m_children(makeProperty<Children>(parent)),
+        m_garbage(0)
+    {
+        connectSignals(parent, child);
+    }
+    SmallLeftMapped(const SmallLeftMapped& other, ParentSystemType<ParentType>& parent, ChildSystemType<ChildType>& child):
+        m_children(other.m_children, parent),
+        m_arena(other.m_arena),
+        m_garbage(other.m_garbage)
+    {
+        connectSignals(parent, child);
     }
     void addChild(ParentType parent, ChildType child)
     {
-       LeftParent::addChild(parent, child);
-       RightParent::addChild(parent, child);
+        Children& children = m_children[parent];
+        if(children.size == children.capacity)
+        {
+            grow(children);
+        }
+        data(children)[children.size++] = child;
+    }
+    template <class RangeType>
+    void addChildren(ParentType parent, const RangeType& children)
+    {
+        Children& theChildren = m_children[parent];
+        reserve(theChildren, theChildren.size + static_cast<std::size_t>(ranges::distance(children)));
+        ChildType* first = data(theChildren);
+        for(ChildType child : children)
+        {
+            first[theChildren.size++] = child;
+        }
+    }
+    // Same as calling addChild for each (parent, child) pair. The children are counted per parent
+    // first, so each parent that spills over gets a block of the right size at once.
+    template <class RangeType>
+    void buildFrom(const RangeType& pairs)
+    {
+        if(m_children.empty())
+        {
+            return;
+        }
+        // Children to add to each parent, by position in m_children.
+        std::vector<std::size_t> pending(m_children.size(), 0);
+        const Children* first = &*m_children.asRange().begin();
+        for(const auto& pair : pairs)
+        {
+            ++pending[&m_children[pair.first] - first];
+        }
+        std::size_t index = 0;
+        for(Children& children : m_children.asRange())
+        {
+            reserve(children, children.size + pending[index++]);
+        }
+        for(const auto& pair : pairs)
+        {
+            Children& children = m_children[pair.first];
+            data(children)[children.size++] = pair.second;
+        }
     }
     void removeChild(ParentType parent, ChildType child)
     {
-        RightParent::removeChild(parent, child);
-        LeftParent::removeChild(parent, child);
+        Children& children = m_children[parent];
+        ChildType* first = data(children);
+        ChildType* last  = first + children.size;
+        ChildType* found = std::find(first, last, child);
+        if(found != last)
+        {
+            std::move(found + 1, last, found);
+            --children.size;
+        }
+    }
+    std::size_t childrenSize(ParentType parent) const
+    {
+        return m_children[parent].size;
+    }
+    auto children(ParentType parent) const
+    {
+        const Children& children = m_children[parent];
+        const ChildType* first = data(children);
+        return ranges::make_iterator_range(first, first + children.size);
+    }
+    // Slots of the arena, including the blocks not reclaimed yet.
+    std::size_t arenaSize() const
+    {
+        return m_arena.size();
     }
-
 private:
-    boost::signals2::scoped_connection m_onEraseChildConnection;
+    struct Children
+    {
+        std::size_t size = 0;
+        std::size_t capacity = N;
+        // Start of the block in the arena once the children spill over.
+        std::size_t offset = 0;
+        std::array<ChildType, N> inlined;
+    };
+
+    ChildType* data(Children& children)
+    {
+        return children.capacity > N ? m_arena.data() + children.offset : children.inlined.data();
+    }
+    const ChildType* data(const Children& children) const
+    {
+        return children.capacity > N ? m_arena.data() + children.offset : children.inlined.data();
+    }
+    void grow(Children& children)
+    {
+        reserve(children, 2 * children.capacity);
+    }
+    // Moves the children to a block of at least capacity slots, if they do not fit.
+    void reserve(Children& children, std::size_t capacity)
+    {
+        if(capacity <= children.capacity)
+        {
+            return;
+        }
+        if(children.capacity > N)
+        {
+            m_garbage += children.capacity;
+        }
+        const std::size_t offset = m_arena.size();
+        m_arena.resize(offset + capacity);
+        const ChildType* first = data(children);
+        std::copy(first, first + children.size, m_arena.begin() + offset);
+        children.offset = offset;
+        children.capacity = capacity;
+        if(2 * m_garbage > m_arena.size())
+        {
+            compact();
+        }
+    }
+    void compact()
+    {
+        std::vector<ChildType> arena;
+        arena.reserve(m_arena.size() - m_garbage);
+        for(Children& children : m_children.asRange())
+        {
+            if(children.capacity > N)
+            {
+                const std::size_t offset = arena.size();
+                arena.insert(arena.end(), m_arena.begin() + children.offset, m_arena.begin() + children.offset + children.capacity);
+                children.offset = offset;
+            }
+        }
+        m_arena.swap(arena);
+        m_garbage = 0;
+    }
+    void connectSignals(ParentSystemType<ParentType>& parent, ChildSystemType<ChildType>& child)
+    {
+        m_children.disconnectOnErase();
+        auto onEraseMany = [this, &child](const std::vector<ParentType>& entities)
+        {
+            std::vector<ChildType> erased;
+            for(ParentType en : entities)
+            {
+                const auto children = this->children(en);
+                erased.insert(erased.end(), children.begin(), children.end());
+                if(m_children[en].capacity > N)
+                {
+                    m_garbage += m_children[en].capacity;
+                }
+            }
+            eraseChildrenIfPossible<ChildType>(0, child, erased);
+            m_children.onEraseMany(entities);
+        };
+        m_onEraseConnection = std::move(parent.notifier->onErase.connect([onEraseMany](ParentType en)
+        {
+            onEraseMany({en});
+        }));
+        m_onEraseManyConnection = std::move(parent.notifier->onEraseMany.connect(onEraseMany));
+    }
+
+    Property<ParentType, Children, ParentSystemType> m_children;
+    std::vector<ChildType> m_arena;
+    std::size_t m_garbage;
+    boost::signals2::scoped_connection m_onEraseConnection;
+    boost::signals2::scoped_connection m_onEraseManyConnection;
 };
 
 // This Conditional helps to select the right Mapping according to the passed Selector.
@@ -280,17 +908,27 @@ struct Conditional
                     std::is_same<Selector, Left>::value,
                     LeftMapped<ParentType, ParentSystemType, ChildType, ChildSystemType>,
                     typename std::conditional<
-                        std::is_same<Selector, Right>::value,
-                        RightMapped<ParentType, ParentSystemType, ChildType, ChildSystemType>,
+                        std::is_same<Selector, DoublyLinkedLeft>::value,
+                        LeftMapped<ParentType, ParentSystemType, ChildType, ChildSystemType, true>,
                         typename std::conditional<
-                            std::is_same<Selector, Both>::value,
-                            BothMapped<ParentType, ParentSystemType, ChildType, ChildSystemType>,
-                            NonMapped<ParentType, ParentSystemType, ChildType, ChildSystemType>
+                            std::is_same<Selector, Right>::value,
+                            RightMapped<ParentType, ParentSystemType, ChildType, ChildSystemType>,
+                            typename std::conditional<
+                                std::is_same<Selector, Both>::value,
+                                BothMapped<ParentType, ParentSystemType, ChildType, ChildSystemType>,
+                                NonMapped<ParentType, ParentSystemType, ChildType, ChildSystemType>
+                            >::type
                         >::type
                      >::type
                  >::type;
 };
 
+template <std::size_t N, typename ParentType, template <typename> class ParentSystemType, typename ChildType, template <typename> class ChildSystemType>
+struct Conditional<SmallLeft<N>, ParentType, ParentSystemType, ChildType, ChildSystemType>
+{
+    using type = SmallLeftMapped<ParentType, ParentSystemType, ChildType, ChildSystemType, N>;
+};
+
 // The Composition class
 template <typename Selector, typename ParentType, template <typename> class ParentSystemType, typename ChildType, template <typename> class ChildSystemType>
 class Composition: public Conditional<Selector, ParentType, ParentSystemType, ChildType, ChildSystemType>::type
@@ -298,7 +936,17 @@ class Composition: public Conditional<Selector, ParentType, ParentSystemType, Ch
     using Parent = typename Conditional<Selector, ParentType, ParentSystemType, ChildType, ChildSystemType>::type;
 public:
     Composition(ParentSystemType<ParentType>& parentSystem, ChildSystemType<ChildType>& childSystem):
-        Parent(parentSystem, childSystem)
+        Parent(parentSystem, childSystem),
+        m_parentSystem(parentSystem),
+        m_childSystem(childSystem)
+    {
+
+    }
+    // Clones other onto copies of its parent and child systems.
+    Composition(const Composition& other, ParentSystemType<ParentType>& parentSystem, ChildSystemType<ChildType>& childSystem):
+        Parent(other, parentSystem, childSystem),
+        m_parentSystem(parentSystem),
+        m_childSystem(childSystem)
     {
 
     }
@@ -306,10 +954,55 @@ public:
     {
         Parent::addChild(parent, child);
     }
+    // Adds children to parent at once.
+    template <class RangeType>
+    void addChildren(ParentType parent, const RangeType& children)
+    {
+        Parent::addChildren(parent, children);
+    }
+    // Adds a whole relation, given as a forward range of (parent, child) pairs, in linear time.
+    template <class RangeType>
+    void buildFrom(const RangeType& pairs)
+    {
+        Parent::buildFrom(pairs);
+    }
     void removeChild(ParentType parent, ChildType child)
     {
         Parent::removeChild(parent, child);
     }
+    // Permutes the child system, and so every property of the children, so that the children of
+    // each parent are contiguous and in the order of children(parent). Clusters follow the order
+    // of the parents, and the children without a parent go last. Walking the children of a parent
+    // then reads each child property sequentially. Needs children(), and a child system with
+    // permute.
+    void clusterChildren()
+    {
+        ChildSystemType<ChildType>& childSystem = m_childSystem.get();
+        const auto indexer = childSystem.indexer();
+        std::vector<ChildType> order;
+        order.reserve(childSystem.size());
+        std::vector<bool> placed(childSystem.size(), false);
+        ranges::for_each(m_parentSystem.get().asRange(), [&](ParentType parent)
+        {
+            ranges::for_each(this->children(parent), [&](ChildType child)
+            {
+                placed[indexer->lookup(child)] = true;
+                order.push_back(child);
+            });
+        });
+        ranges::for_each(childSystem.asRange(), [&](ChildType child)
+        {
+            if(!placed[indexer->lookup(child)])
+            {
+                order.push_back(child);
+            }
+        });
+        childSystem.permute(order);
+    }
+
+private:
+    std::reference_wrapper<ParentSystemType<ParentType>> m_parentSystem;
+    std::reference_wrapper<ChildSystemType<ChildType>>   m_childSystem;
 };
 
 template <typename Selector, typename ParentType, template <typename> class ParentSystemType, typename ChildType, template <typename> class ChildSystemType>
@@ -342,6 +1035,14 @@ public:
     {
         return m_system.size();
     }
+    auto asRange() const
+    {
+        return m_system.asRange();
+    }
+    void permute(const std::vector<EntityType>& entities)
+    {
+        m_system.permute(entities);
+    }
     
     std::shared_ptr<Notifier>& notifier;
     SystemWithDeletion<EntityType>& m_system;
@@ -0,0 +1,165 @@
+#ifndef CONCURRENTKEYWRAPPER_HPP
+#define CONCURRENTKEYWRAPPER_HPP
+
+#include <array>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include "KeyTable.hpp"
+#include "Property.hpp"
+#include "StringPool.hpp"
+
+namespace Entity
+{
+
+// String key wrapper for many threads adding keys at once, e.g. while parsing several files in
+// parallel. The keys are partitioned by hash into shards, each with its own lock, pool and table,
+// so threads resolving different keys rarely wait for each other. Creating an entity takes one
+// more lock, held only around the system's add: systems and their properties are not thread-safe.
+// addOrGet, has and at can run concurrently; key and erasing entities must not overlap with them.
+// A shard keeps the local slot and the bytes of an erased key, so a key that comes back gets them
+// again: erasing and adding the same keys does not grow the shards.
+template <typename ValueType, template <typename> class SystemType, std::size_t Shards = 16>
+class ConcurrentKeyWrapper final
+{
+    static_assert(Shards > 0 && (Shards & (Shards - 1)) == 0, "The number of shards must be a power of two");
+    static_assert(Shards <= 256, "The shard is picked with the top 8 bits of the hash");
+public:
+    ConcurrentKeyWrapper(SystemType<ValueType>& system) :
+        m_system(system),
+        m_keys(makeProperty<boost::string_view>(system))
+    {
+        m_keys.disconnectOnErase();
+        m_onEraseConnection     = std::move(system.notifier->onErase.connect([this](ValueType en)
+        {
+            this->remove(en);
+            m_keys.onErase(en);
+        }));
+        // remove() reads the key of the entity, so every entity leaves its shard before the
+        // column is compacted.
+        m_onEraseManyConnection = std::move(system.notifier->onEraseMany.connect([this](const std::vector<ValueType>& entities)
+        {
+            for(ValueType en : entities)
+            {
+                this->remove(en);
+            }
+            m_keys.onEraseMany(entities);
+        }));
+    }
+    ConcurrentKeyWrapper(const ConcurrentKeyWrapper&) = delete;
+    ConcurrentKeyWrapper& operator=(const ConcurrentKeyWrapper&) = delete;
+
+    ValueType addOrGet(boost::string_view key)
+    {
+        const std::size_t hash     = hashKey(key);
+        Shard&            theShard = shard(hash);
+        std::lock_guard<std::mutex> lock(theShard.mutex);
+        std::size_t local = theShard.find(hash, key);
+        if(local != KeyTable::npos() && theShard.entities[local] != KeyTable::npos())
+        {
+            return ValueType{theShard.entities[local]};
+        }
+        if(local == KeyTable::npos())
+        {
+            if(theShard.table.full())
+            {
+                theShard.table.grow();
+            }
+            local = theShard.keys.size();
+            theShard.keys.push_back(theShard.pool.append(key));
+            theShard.entities.push_back(KeyTable::npos());
+            theShard.table.insert(hash, local);
+        }
+        ValueType en;
+        {
+            std::lock_guard<std::mutex> allocation(m_allocationMutex);
+            en = m_system.get().add();
+            m_keys[en] = theShard.keys[local];
+        }
+        theShard.entities[local] = en.id();
+        return en;
+    }
+    bool has(boost::string_view key) const
+    {
+        const std::size_t hash     = hashKey(key);
+        const Shard&      theShard = shard(hash);
+        std::lock_guard<std::mutex> lock(theShard.mutex);
+        const std::size_t local = theShard.find(hash, key);
+        return local != KeyTable::npos() && theShard.entities[local] != KeyTable::npos();
+    }
+    ValueType at(boost::string_view key) const
+    {
+        const std::size_t hash     = hashKey(key);
+        const Shard&      theShard = shard(hash);
+        std::lock_guard<std::mutex> lock(theShard.mutex);
+        const std::size_t local = theShard.find(hash, key);
+        if(local == KeyTable::npos() || theShard.entities[local] == KeyTable::npos())
+        {
+            throw std::out_of_range("ConcurrentKeyWrapper::at");
+        }
+        return ValueType{theShard.entities[local]};
+    }
+    boost::string_view key(ValueType en) const
+    {
+        return m_keys[en];
+    }
+
+private:
+    // Padded by a cache line, so that locking a shard does not slow down its neighbours. alignas
+    // would not do: C++14 operator new ignores over-alignment, e.g. for a wrapper in a shared_ptr.
+    struct Shard
+    {
+        std::size_t find(std::size_t hash, boost::string_view key) const
+        {
+            return table.find(hash, [&](std::size_t local)
+            {
+                return keys[local] == key;
+            });
+        }
+
+        mutable std::mutex              mutex;
+        StringPool                      pool;
+        // Maps every key the shard has seen to its local index, which indexes keys and entities.
+        // The entity of an erased key is npos().
+        KeyTable                        table;
+        std::vector<boost::string_view> keys;
+        std::vector<std::size_t>        entities;
+        char                            padding[64];
+    };
+
+    void remove(ValueType en)
+    {
+        const auto key      = m_keys[en];
+        const auto hash     = hashKey(key);
+        Shard&     theShard = shard(hash);
+        std::lock_guard<std::mutex> lock(theShard.mutex);
+        const std::size_t local = theShard.find(hash, key);
+        if(local != KeyTable::npos() && theShard.entities[local] == en.id())
+        {
+            theShard.entities[local] = KeyTable::npos();
+        }
+    }
+
+    // The low bits of the hash pick the slot in the table, so the shard is picked with the high ones.
+    Shard& shard(std::size_t hash)
+    {
+        return m_shards[(hash >> (8 * sizeof(std::size_t) - 8)) & (Shards - 1)];
+    }
+    const Shard& shard(std::size_t hash) const
+    {
+        return m_shards[(hash >> (8 * sizeof(std::size_t) - 8)) & (Shards - 1)];
+    }
+
+    std::reference_wrapper<SystemType<ValueType>> m_system;
+    Property<ValueType, boost::string_view, SystemType> m_keys;
+    char m_padding[64];
+    std::array<Shard, Shards> m_shards;
+    std::mutex m_allocationMutex;
+    boost::signals2::scoped_connection m_onEraseConnection;
+    boost::signals2::scoped_connection m_onEraseManyConnection;
+};
+
+}
+
+#endif // CONCURRENTKEYWRAPPER_HPP
@@ -0,0 +1,152 @@
+#ifndef EULERTOURINDEX_HPP
+#define EULERTOURINDEX_HPP
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "Property.hpp"
+
+namespace Entity
+{
+
+// Interval labels of a forest kept in a composition whose parent and child systems are the same
+// (Left, DoublyLinkedLeft or Both). Walking the forest in preorder gives every node an entry index,
+// and the nodes below it take the indices up to its exit index, so "is a below b" is two compares
+// and a subtree is a contiguous range of the preorder. The labels are rebuilt in linear time by the
+// first query after the composition or the system changed, which makes the queries modify the
+// index: concurrent readers must call rebuild() beforehand.
+template <class CompositionType, typename NodeType, template <typename> class SystemType>
+class EulerTourIndex final
+{
+public:
+    EulerTourIndex(const CompositionType& composition, SystemType<NodeType>& system) :
+        m_composition(composition),
+        m_system(system),
+        m_entry(makeProperty<std::size_t>(system)),
+        m_exit(makeProperty<std::size_t>(system)),
+        m_version(0),
+        m_size(0),
+        m_built(false)
+    {
+
+    }
+    EulerTourIndex(EulerTourIndex&&) = default;
+    EulerTourIndex(const EulerTourIndex&) = delete;
+    EulerTourIndex& operator=(const EulerTourIndex&) = delete;
+
+    bool stale() const
+    {
+        return !m_built || m_version != m_composition.version() || m_size != m_system.size();
+    }
+    // Position of node in the preorder of the forest.
+    std::size_t entry(NodeType node) const
+    {
+        update();
+        return m_entry[node];
+    }
+    // One past the position of the last node below node.
+    std::size_t exit(NodeType node) const
+    {
+        update();
+        return m_exit[node];
+    }
+    // True if node is below ancestor, or is ancestor itself.
+    bool contains(NodeType ancestor, NodeType node) const
+    {
+        update();
+        return m_entry[ancestor] <= m_entry[node] && m_entry[node] < m_exit[ancestor];
+    }
+    bool isAncestor(NodeType ancestor, NodeType node) const
+    {
+        return ancestor != node && contains(ancestor, node);
+    }
+    // Nodes below node, node first, in preorder.
+    auto subtree(NodeType node) const
+    {
+        update();
+        return ranges::make_iterator_range(m_order.cbegin() + m_entry[node], m_order.cbegin() + m_exit[node]);
+    }
+    // Whole forest in preorder.
+    const std::vector<NodeType>& order() const
+    {
+        update();
+        return m_order;
+    }
+    void rebuild() const;
+
+private:
+    void update() const
+    {
+        if(stale())
+        {
+            rebuild();
+        }
+    }
+
+    const CompositionType&                                      m_composition;
+    SystemType<NodeType>&                                       m_system;
+    mutable Property<NodeType, std::size_t, SystemType>         m_entry;
+    mutable Property<NodeType, std::size_t, SystemType>         m_exit;
+    mutable std::vector<NodeType>                               m_order;
+    mutable std::vector<std::pair<NodeType, bool>>              m_stack;
+    mutable std::size_t                                         m_version;
+    mutable std::size_t                                         m_size;
+    mutable bool                                                m_built;
+};
+
+template <class CompositionType, typename NodeType, template <typename> class SystemType>
+void EulerTourIndex<CompositionType, NodeType, SystemType>::rebuild() const
+{
+    // Children are marked first, so that the roots are the nodes left unmarked.
+    const std::size_t unmarked = std::numeric_limits<std::size_t>::max();
+    ranges::fill(m_entry.asRange(), unmarked);
+    ranges::for_each(m_system.asRange(), [this](NodeType node)
+    {
+        ranges::for_each(m_composition.children(node), [this](NodeType child)
+        {
+            m_entry[child] = 0;
+        });
+    });
+    m_order.clear();
+    ranges::for_each(m_system.asRange(), [this, unmarked](NodeType root)
+    {
+        if(m_entry[root] != unmarked)
+        {
+            return;
+        }
+        m_stack.emplace_back(root, false);
+        while(!m_stack.empty())
+        {
+            const NodeType node = m_stack.back().first;
+            if(m_stack.back().second)
+            {
+                m_exit[node] = m_order.size();
+                m_stack.pop_back();
+                continue;
+            }
+            m_stack.back().second = true;
+            m_entry[node] = m_order.size();
+            m_order.push_back(node);
+            const std::size_t first = m_stack.size();
+            ranges::for_each(m_composition.children(node), [this](NodeType child)
+            {
+                m_stack.emplace_back(child, false);
+            });
+            std::reverse(m_stack.begin() + first, m_stack.end());
+        }
+    });
+    m_version = m_composition.version();
+    m_size    = m_system.size();
+    m_built   = true;
+}
+
+template <class CompositionType, typename NodeType, template <typename> class SystemType>
+EulerTourIndex<CompositionType, NodeType, SystemType> makeEulerTourIndex(const CompositionType& composition, SystemType<NodeType>& system)
+{
+    return {composition, system};
+}
+
+}
+
+#endif // EULERTOURINDEX_HPP
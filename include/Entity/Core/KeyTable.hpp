@@ -0,0 +1,210 @@
+#ifndef KEYTABLE_HPP
+#define KEYTABLE_HPP
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <boost/utility/string_view.hpp>
+
+namespace Entity
+{
+
+// 64 bit FNV-1a.
+inline std::size_t hashKey(boost::string_view key)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    for(const char c : key)
+    {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    }
+    return static_cast<std::size_t>(hash ^ (hash >> 32));
+}
+
+// Hint that address will be read soon.
+inline void prefetch(const void* address)
+{
+#if defined(__GNUC__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+}
+
+// Open addressing table of (hash, entity id) pairs with linear probing. The keys themselves are
+// not stored: lookups compare the full hash first and only then call back to compare the key of
+// the candidate entity, so a probe reads one contiguous run of 16 byte slots. Erasing shifts the
+// following slots back, so no tombstones are needed.
+class KeyTable final
+{
+public:
+    struct Slot
+    {
+        std::size_t hash;
+        std::size_t id;
+    };
+
+    KeyTable() :
+        m_slots(8, Slot{0, npos()}),
+        m_size(0)
+    {
+
+    }
+    std::size_t size() const
+    {
+        return m_size;
+    }
+    std::size_t capacity() const
+    {
+        return m_slots.size();
+    }
+    // True when one more insertion would exceed the maximum load factor of 7/8.
+    bool full() const
+    {
+        return (m_size + 1) * 8 > m_slots.size() * 7;
+    }
+    // Id of the entry with this hash for which equal(id) holds, npos() if there is none.
+    template <class Equal>
+    std::size_t find(std::size_t hash, Equal equal) const
+    {
+        for(std::size_t index = home(hash); m_slots[index].id != npos(); index = next(index))
+        {
+            if(m_slots[index].hash == hash && equal(m_slots[index].id))
+            {
+                return m_slots[index].id;
+            }
+        }
+        return npos();
+    }
+    // Prefetches the first slot a find(hash, ...) will read.
+    void prefetch(std::size_t hash) const
+    {
+        Entity::prefetch(&m_slots[home(hash)]);
+    }
+    // Inserts without looking for an equal entry, the table must not be full().
+    void insert(std::size_t hash, std::size_t id)
+    {
+        std::size_t index = home(hash);
+        while(m_slots[index].id != npos())
+        {
+            index = next(index);
+        }
+        m_slots[index] = Slot{hash, id};
+        ++m_size;
+    }
+    template <class Equal>
+    bool erase(std::size_t hash, Equal equal)
+    {
+        for(std::size_t index = home(hash); m_slots[index].id != npos(); index = next(index))
+        {
+            if(m_slots[index].hash == hash && equal(m_slots[index].id))
+            {
+                eraseAt(index);
+                return true;
+            }
+        }
+        return false;
+    }
+    template <class Callable>
+    void forEach(Callable callable) const
+    {
+        for(const Slot& slot : m_slots)
+        {
+            if(slot.id != npos())
+            {
+                callable(slot);
+            }
+        }
+    }
+    // Doubles the capacity of a full table.
+    void grow()
+    {
+        rehash([](std::size_t)
+        {
+            return true;
+        });
+    }
+    // Rebuilds the table with the entries for which keep(id) holds, doubling its capacity if they
+    // would still fill it.
+    template <class Predicate>
+    void rehash(Predicate keep)
+    {
+        std::size_t kept = 0;
+        for(const Slot& slot : m_slots)
+        {
+            kept += (slot.id != npos() && keep(slot.id));
+        }
+        rebuild(capacityFor(kept, m_slots.size()), keep);
+    }
+    // Grows the table once so that size entries fit without growing again.
+    void reserve(std::size_t size)
+    {
+        const std::size_t capacity = capacityFor(size, m_slots.size());
+        if(capacity != m_slots.size())
+        {
+            rebuild(capacity, [](std::size_t)
+            {
+                return true;
+            });
+        }
+    }
+    static constexpr std::size_t npos()
+    {
+        return std::numeric_limits<std::size_t>::max();
+    }
+
+private:
+    // Smallest power of two times capacity that is not full() with size entries.
+    static std::size_t capacityFor(std::size_t size, std::size_t capacity)
+    {
+        while((size + 1) * 8 > capacity * 7)
+        {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+    template <class Predicate>
+    void rebuild(std::size_t capacity, Predicate keep)
+    {
+        std::vector<Slot> slots;
+        slots.swap(m_slots);
+        m_slots.assign(capacity, Slot{0, npos()});
+        m_size = 0;
+        for(const Slot& slot : slots)
+        {
+            if(slot.id != npos() && keep(slot.id))
+            {
+                insert(slot.hash, slot.id);
+            }
+        }
+    }
+    std::size_t home(std::size_t hash) const
+    {
+        return hash & (m_slots.size() - 1);
+    }
+    std::size_t next(std::size_t index) const
+    {
+        return (index + 1) & (m_slots.size() - 1);
+    }
+    void eraseAt(std::size_t hole)
+    {
+        for(std::size_t index = next(hole); m_slots[index].id != npos(); index = next(index))
+        {
+            // An entry may fill the hole if the hole lies between its home and its current slot.
+            const std::size_t mask = m_slots.size() - 1;
+            if(((index - home(m_slots[index].hash)) & mask) >= ((index - hole) & mask))
+            {
+                m_slots[hole] = m_slots[index];
+                hole = index;
+            }
+        }
+        m_slots[hole] = Slot{0, npos()};
+        --m_size;
+    }
+
+    std::vector<Slot> m_slots;
+    std::size_t       m_size;
+};
+
+}
+
+#endif // KEYTABLE_HPP
@@ -1,13 +1,22 @@
 #ifndef KEYWRAPPER_HPP
 #define KEYWRAPPER_HPP
 
+#include <array>
 #include <functional>
+#include <iterator>
+#include <string>
 #include <unordered_map>
+#include <stdexcept>
+#include "KeyTable.hpp"
+#include "PerfectHash.hpp"
 #include "Property.hpp"
+#include "StringPool.hpp"
 
 namespace Entity
 {
 
+// Maps keys to entities and back. The key of an entity is forgotten as soon as the entity is
+// erased, so the const lookups never modify the wrapper and can run concurrently.
 template <typename ValueType, typename KeyType, template <typename> class SystemType>
 class KeyWrapper final
 {
@@ -16,7 +25,23 @@ public:
         m_system(system),
         m_keys(makeProperty<KeyType>(system))
     {
-
+        connectSignals();
+    }
+    KeyWrapper(const KeyWrapper& other, SystemType<ValueType>& system) :
+        m_system(system),
+        m_keys(other.m_keys, system),
+        m_map(other.m_map)
+    {
+        connectSignals();
+    }
+    KeyWrapper(KeyWrapper&& other) :
+        m_system(other.m_system),
+        m_keys(std::move(other.m_keys)),
+        m_map(std::move(other.m_map))
+    {
+        other.m_onEraseConnection.disconnect();
+        other.m_onEraseManyConnection.disconnect();
+        connectSignals();
     }
     ~KeyWrapper()
     {
@@ -37,17 +62,7 @@ public:
 
     bool has(KeyType key) const
     {
-        auto resultIt = m_map.find(key);
-        if (resultIt != m_map.end())
-        {
-            if (m_system.get().alive(resultIt->second))
-            {
-                return true;
-            }
-            m_map.erase(resultIt);
-            return false;
-        }
-        return false;
+        return m_map.find(key) != m_map.end();
     }
 
     ValueType at(KeyType key) const
@@ -61,9 +76,307 @@ public:
     }
 
 private:
+    // The key of an erased entity is still needed to find its entry, so the keys property is erased
+    // after the map.
+    void connectSignals()
+    {
+        m_keys.disconnectOnErase();
+        auto onErase = [this](ValueType en)
+        {
+            auto resultIt = m_map.find(m_keys[en]);
+            if (resultIt != m_map.end() && resultIt->second == en)
+            {
+                m_map.erase(resultIt);
+            }
+            m_keys.onErase(en);
+        };
+        m_onEraseConnection     = std::move(m_system.get().notifier->onErase.connect(onErase));
+        m_onEraseManyConnection = std::move(m_system.get().notifier->onEraseMany.connect([onErase](const std::vector<ValueType>& entities)
+        {
+            for(ValueType en : entities)
+            {
+                onErase(en);
+            }
+        }));
+    }
+
     std::reference_wrapper<SystemType<ValueType>> m_system;
     Property<ValueType, KeyType, SystemType> m_keys;
-    mutable std::unordered_map<KeyType, ValueType> m_map;
+    std::unordered_map<KeyType, ValueType> m_map;
+    boost::signals2::scoped_connection m_onEraseConnection;
+    boost::signals2::scoped_connection m_onEraseManyConnection;
+
+};
+
+// String keys are interned: every key is stored once, in a StringPool, and the keys property refers
+// to it through string views. The index is a flat KeyTable of (hash, id) pairs whose candidates are
+// checked against the keys property, and lookups take views, so a hit allocates nothing. Clones
+// share the pool, but neither appends to it any more: a wrapper whose pool is shared moves to a
+// fresh one for its first new key, and keeps the shared one alive for the views of its old keys.
+// As above, erased entities are forgotten at once and the const lookups are read-only. The slot of
+// an erased key is kept, retired, with the view of its bytes, so a key that comes back reuses them
+// and churn on a fixed set of keys does not grow the pool.
+// A key set that is loaded once and then only queried can be frozen: lookups then go through a
+// PerfectHash and read a single slot. Erasing keeps the wrapper frozen, adding a new key thaws it.
+template <typename ValueType, template <typename> class SystemType>
+class KeyWrapper<ValueType, std::string, SystemType> final
+{
+public:
+    KeyWrapper(SystemType<ValueType>& system) :
+        m_system(system),
+        m_pool(std::make_shared<StringPool>()),
+        m_keys(makeProperty<boost::string_view>(system))
+    {
+        connectSignals();
+    }
+    KeyWrapper(const KeyWrapper& other, SystemType<ValueType>& system) :
+        m_system(system),
+        m_pool(other.m_pool),
+        m_sharedPools(other.m_sharedPools),
+        m_keys(other.m_keys, system),
+        m_table(other.m_table),
+        m_retired(other.m_retired),
+        m_frozen(other.m_frozen)
+    {
+        connectSignals();
+    }
+    KeyWrapper(KeyWrapper&& other) :
+        m_system(other.m_system),
+        m_pool(std::move(other.m_pool)),
+        m_sharedPools(std::move(other.m_sharedPools)),
+        m_keys(std::move(other.m_keys)),
+        m_table(std::move(other.m_table)),
+        m_retired(std::move(other.m_retired)),
+        m_frozen(std::move(other.m_frozen))
+    {
+        other.m_onEraseConnection.disconnect();
+        other.m_onEraseManyConnection.disconnect();
+        connectSignals();
+    }
+
+    ValueType addOrGet(boost::string_view key)
+    {
+        const std::size_t hash = hashKey(key);
+        const std::size_t id   = find(hash, key);
+        if (id != KeyTable::npos())
+        {
+            return ValueType{id};
+        }
+        m_frozen.clear();
+        const std::size_t retired = m_table.find(hash, [&](std::size_t other)
+        {
+            return (other & Retired) != 0 && m_retired[other & ~Retired] == key;
+        });
+        const boost::string_view stored = retired == KeyTable::npos() ? ownPool().append(key) : m_retired[retired & ~Retired];
+        if (retired != KeyTable::npos())
+        {
+            unretire(hash, retired);
+        }
+        if (m_table.full())
+        {
+            m_table.grow();
+        }
+        ValueType en = m_system.get().add();
+        m_keys[en] = stored;
+        m_table.insert(hash, en.id());
+        return en;
+    }
+
+    // Adds the keys which are not there yet and freezes. If the range can be walked twice (it is a
+    // forward range), the system and the table first reserve room for all of the keys; keys read
+    // once, e.g. streamed from a file, are loaded as they come.
+    template <class RangeType>
+    void bulkLoad(RangeType&& keys)
+    {
+        using Iterator = decltype(ranges::begin(keys));
+        reserve(keys, typename std::iterator_traits<Iterator>::iterator_category{});
+        ranges::for_each(keys, [this](boost::string_view key)
+        {
+            this->addOrGet(key);
+        });
+        freeze();
+    }
+
+    // Builds the perfect hash over the current keys. Returns false if it could not be built, in
+    // which case lookups keep using the table.
+    bool freeze()
+    {
+        return m_frozen.build(m_table, [](std::size_t id)
+        {
+            return (id & Retired) == 0;
+        });
+    }
+
+    bool frozen() const
+    {
+        return !m_frozen.empty();
+    }
+
+    bool has(boost::string_view key) const
+    {
+        return find(hashKey(key), key) != KeyTable::npos();
+    }
+
+    ValueType at(boost::string_view key) const
+    {
+        const std::size_t id = find(hashKey(key), key);
+        if (id == KeyTable::npos())
+        {
+            throw std::out_of_range("KeyWrapper::at");
+        }
+        return ValueType{id};
+    }
+
+    // Writes the entity of each key to out, ValueType{} for the missing ones. The keys are hashed and
+    // their slots prefetched a block at a time before any of them is compared, so the cache misses
+    // of a block overlap instead of following one another. The keys must outlive the iteration.
+    template <class RangeType, class OutputIterator>
+    OutputIterator lookupBatch(const RangeType& keys, OutputIterator out) const
+    {
+        std::array<boost::string_view, BatchSize> block;
+        std::array<std::size_t, BatchSize> hashes;
+        std::size_t size = 0;
+        auto resolve = [&]()
+        {
+            for (std::size_t index = 0; index < size; ++index)
+            {
+                hashes[index] = hashKey(block[index]);
+                if (m_frozen.empty())
+                {
+                    m_table.prefetch(hashes[index]);
+                }
+                else
+                {
+                    m_frozen.prefetchSeed(hashes[index]);
+                }
+            }
+            if (!m_frozen.empty())
+            {
+                for (std::size_t index = 0; index < size; ++index)
+                {
+                    m_frozen.prefetch(hashes[index]);
+                }
+            }
+            for (std::size_t index = 0; index < size; ++index)
+            {
+                const std::size_t id = find(hashes[index], block[index]);
+                *out++ = id == KeyTable::npos() ? ValueType{} : ValueType{id};
+            }
+            size = 0;
+        };
+        for (const auto& key : keys)
+        {
+            block[size++] = key;
+            if (size == BatchSize)
+            {
+                resolve();
+            }
+        }
+        resolve();
+        return out;
+    }
+
+    boost::string_view key(ValueType en) const
+    {
+        return m_keys[en];
+    }
+
+    const StringPool& pool() const
+    {
+        return *m_pool;
+    }
+
+private:
+    static constexpr std::size_t BatchSize = 16;
+    StringPool& ownPool()
+    {
+        if (m_pool.use_count() > 1)
+        {
+            m_sharedPools.push_back(std::move(m_pool));
+            m_pool = std::make_shared<StringPool>();
+        }
+        return *m_pool;
+    }
+    template <class RangeType>
+    void reserve(RangeType& keys, std::forward_iterator_tag)
+    {
+        const std::size_t count = ranges::distance(keys);
+        m_system.get().reserve(m_system.get().size() + count);
+        m_table.reserve(m_table.size() + count);
+    }
+    template <class RangeType>
+    void reserve(RangeType&, std::input_iterator_tag)
+    {
+
+    }
+    // Tag of the ids of retired slots, whose other bits index m_retired.
+    static constexpr std::size_t Retired = ~(KeyTable::npos() >> 1);
+
+    std::size_t find(std::size_t hash, boost::string_view key) const
+    {
+        auto equal = [&](std::size_t id)
+        {
+            return (id & Retired) == 0 && m_keys[ValueType{id}] == key;
+        };
+        return m_frozen.empty() ? m_table.find(hash, equal) : m_frozen.find(hash, equal);
+    }
+    // Retires the slot of an erased entity.
+    void retire(ValueType en)
+    {
+        const boost::string_view key  = m_keys[en];
+        const std::size_t        hash = hashKey(key);
+        m_frozen.erase(hash, en.id());
+        if (m_table.erase(hash, [&](std::size_t id){ return id == en.id(); }))
+        {
+            m_table.insert(hash, Retired | m_retired.size());
+            m_retired.push_back(key);
+        }
+    }
+    // Drops a retired slot, moving the last retired key in its place in m_retired.
+    void unretire(std::size_t hash, std::size_t retired)
+    {
+        m_table.erase(hash, [&](std::size_t id){ return id == retired; });
+        const std::size_t last = Retired | (m_retired.size() - 1);
+        if (retired != last)
+        {
+            const std::size_t lastHash = hashKey(m_retired.back());
+            m_table.erase(lastHash, [&](std::size_t id){ return id == last; });
+            m_table.insert(lastHash, retired);
+            m_retired[retired & ~Retired] = m_retired.back();
+        }
+        m_retired.pop_back();
+    }
+    void connectSignals()
+    {
+        m_keys.disconnectOnErase();
+        m_onEraseConnection     = std::move(m_system.get().notifier->onErase.connect([this](ValueType en)
+        {
+            this->retire(en);
+            m_keys.onErase(en);
+        }));
+        // retire() reads the key of the entity, so every entity is retired before the keys column
+        // is compacted.
+        m_onEraseManyConnection = std::move(m_system.get().notifier->onEraseMany.connect([this](const std::vector<ValueType>& entities)
+        {
+            for(ValueType en : entities)
+            {
+                this->retire(en);
+            }
+            m_keys.onEraseMany(entities);
+        }));
+    }
+
+    std::reference_wrapper<SystemType<ValueType>> m_system;
+    std::shared_ptr<StringPool> m_pool;
+    // Pools shared with clones, which hold the bytes of keys added before the cloning.
+    std::vector<std::shared_ptr<const StringPool>> m_sharedPools;
+    Property<ValueType, boost::string_view, SystemType> m_keys;
+    KeyTable m_table;
+    // Keys of the retired slots of the table.
+    std::vector<boost::string_view> m_retired;
+    PerfectHash m_frozen;
+    boost::signals2::scoped_connection m_onEraseConnection;
+    boost::signals2::scoped_connection m_onEraseManyConnection;
 
 };
 
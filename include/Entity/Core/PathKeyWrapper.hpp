@@ -0,0 +1,425 @@
+#ifndef PATHKEYWRAPPER_HPP
+#define PATHKEYWRAPPER_HPP
+
+#include <array>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "KeyTable.hpp"
+#include "Property.hpp"
+#include "StringPool.hpp"
+#include <boost/iterator/function_output_iterator.hpp>
+
+namespace Entity
+{
+
+// Hierarchical names ("top.u1.n0") stored as a tree: every node holds its parent and its last
+// segment, and equal segments are interned once. A shared prefix is stored once however many names
+// extend it, and full names are only rebuilt on demand. Nodes are never removed.
+class PathTree final
+{
+public:
+    using Node = std::size_t;
+
+    explicit PathTree(char separator = '.') :
+        m_separator(separator),
+        m_parents(1, npos()),
+        m_nodeSegments(1, npos())
+    {
+
+    }
+    // Deep copy: the segments are copied into a pool of the copy's own, so the copy and the
+    // original can grow apart, e.g. on different threads. Nodes keep their values.
+    PathTree(const PathTree& other) :
+        m_separator(other.m_separator),
+        m_segmentTable(other.m_segmentTable),
+        m_parents(other.m_parents),
+        m_nodeSegments(other.m_nodeSegments),
+        m_children(other.m_children)
+    {
+        m_segments.reserve(other.m_segments.size());
+        for(boost::string_view segment : other.m_segments)
+        {
+            m_segments.push_back(m_pool.append(segment));
+        }
+    }
+    PathTree& operator=(const PathTree&) = delete;
+    static constexpr Node root()
+    {
+        return 0;
+    }
+    static constexpr Node npos()
+    {
+        return KeyTable::npos();
+    }
+    char separator() const
+    {
+        return m_separator;
+    }
+    // Number of nodes, including the root.
+    std::size_t size() const
+    {
+        return m_parents.size();
+    }
+    Node parent(Node node) const
+    {
+        return m_parents[node];
+    }
+    boost::string_view segment(Node node) const
+    {
+        return node == root() ? boost::string_view{} : m_segments[m_nodeSegments[node]];
+    }
+    // Child of parent named segment, npos() if there is none.
+    Node child(Node parent, boost::string_view segment) const
+    {
+        const std::size_t id = findSegment(hashKey(segment), segment);
+        return id == npos() ? npos() : findChild(parent, id);
+    }
+    Node addOrGetChild(Node parent, boost::string_view segment)
+    {
+        const std::size_t id   = addOrGetSegment(segment);
+        const Node        node = findChild(parent, id);
+        if(node != npos())
+        {
+            return node;
+        }
+        if(m_children.full())
+        {
+            m_children.grow();
+        }
+        m_children.insert(childHash(parent, id), m_parents.size());
+        m_parents.push_back(parent);
+        m_nodeSegments.push_back(id);
+        return m_parents.size() - 1;
+    }
+    // Writes child(parent, segment) of each segment to out. A lookup reads the segment table and
+    // then the children table: both are prefetched for a block of segments before it is resolved.
+    // The segments must outlive the iteration.
+    template <class RangeType, class OutputIterator>
+    OutputIterator children(Node parent, const RangeType& segments, OutputIterator out) const
+    {
+        std::array<boost::string_view, BatchSize> block;
+        std::array<std::size_t, BatchSize> hashes;
+        std::array<std::size_t, BatchSize> ids;
+        std::size_t size = 0;
+        auto resolve = [&]()
+        {
+            for(std::size_t index = 0; index < size; ++index)
+            {
+                hashes[index] = hashKey(block[index]);
+                m_segmentTable.prefetch(hashes[index]);
+            }
+            for(std::size_t index = 0; index < size; ++index)
+            {
+                ids[index] = findSegment(hashes[index], block[index]);
+                if(ids[index] != npos())
+                {
+                    m_children.prefetch(childHash(parent, ids[index]));
+                }
+            }
+            for(std::size_t index = 0; index < size; ++index)
+            {
+                *out++ = ids[index] == npos() ? npos() : findChild(parent, ids[index]);
+            }
+            size = 0;
+        };
+        for(const auto& segment : segments)
+        {
+            block[size++] = segment;
+            if(size == BatchSize)
+            {
+                resolve();
+            }
+        }
+        resolve();
+        return out;
+    }
+    // Node of a path relative to from, npos() if some segment is missing.
+    Node find(boost::string_view path, Node from = root()) const
+    {
+        Node node = from;
+        forEachSegment(path, [&](boost::string_view segment)
+        {
+            node = node == npos() ? npos() : child(node, segment);
+        });
+        return node;
+    }
+    Node addOrGet(boost::string_view path, Node from = root())
+    {
+        Node node = from;
+        forEachSegment(path, [&](boost::string_view segment)
+        {
+            node = addOrGetChild(node, segment);
+        });
+        return node;
+    }
+    // Full name of node, from the root.
+    std::string path(Node node) const
+    {
+        std::size_t length = 0;
+        for(Node current = node; current != root(); current = m_parents[current])
+        {
+            length += segment(current).size() + 1;
+        }
+        std::string result(length > 0 ? length - 1 : 0, m_separator);
+        for(Node current = node; current != root(); current = m_parents[current])
+        {
+            const auto theSegment = segment(current);
+            length -= theSegment.size() + 1;
+            std::copy(theSegment.begin(), theSegment.end(), result.begin() + length);
+        }
+        return result;
+    }
+    // Bytes used by the distinct segments.
+    std::size_t bytes() const
+    {
+        return m_pool.bytes();
+    }
+
+private:
+    static constexpr std::size_t BatchSize = 16;
+
+    template <class Callable>
+    void forEachSegment(boost::string_view path, Callable callable) const
+    {
+        while(!path.empty())
+        {
+            const std::size_t end = path.find(m_separator);
+            callable(path.substr(0, end));
+            path = end == boost::string_view::npos ? boost::string_view{} : path.substr(end + 1);
+        }
+    }
+    static std::size_t childHash(Node parent, std::size_t segment)
+    {
+        std::uint64_t hash = (parent * 0x9e3779b97f4a7c15ull) ^ segment;
+        hash ^= hash >> 32;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 29;
+        return static_cast<std::size_t>(hash);
+    }
+    std::size_t findSegment(std::size_t hash, boost::string_view segment) const
+    {
+        return m_segmentTable.find(hash, [&](std::size_t id)
+        {
+            return m_segments[id] == segment;
+        });
+    }
+    std::size_t addOrGetSegment(boost::string_view segment)
+    {
+        const std::size_t hash = hashKey(segment);
+        const std::size_t id   = findSegment(hash, segment);
+        if(id != npos())
+        {
+            return id;
+        }
+        if(m_segmentTable.full())
+        {
+            m_segmentTable.grow();
+        }
+        m_segments.push_back(m_pool.append(segment));
+        m_segmentTable.insert(hash, m_segments.size() - 1);
+        return m_segments.size() - 1;
+    }
+    Node findChild(Node parent, std::size_t segment) const
+    {
+        return m_children.find(childHash(parent, segment), [&](Node node)
+        {
+            return m_parents[node] == parent && m_nodeSegments[node] == segment;
+        });
+    }
+
+    char                            m_separator;
+    StringPool                      m_pool;
+    std::vector<boost::string_view> m_segments;
+    KeyTable                        m_segmentTable;
+    std::vector<Node>               m_parents;
+    std::vector<std::size_t>        m_nodeSegments;
+    KeyTable                        m_children;
+};
+
+// Maps the nodes of a PathTree to the entities of a system. Several wrappers can share one tree, so
+// e.g. the wires and ports of a module are named relative to the node of the module. Each entity
+// stores only its node, and its full name is rebuilt by key(). The entity of a node is found in a
+// KeyTable of the wrapper's own entities, so a wrapper costs nothing for the nodes of the others.
+// As KeyWrapper, it forgets the node of an erased entity at once, so the const lookups are read-only.
+template <typename ValueType, template <typename> class SystemType>
+class PathKeyWrapper final
+{
+public:
+    using Node = PathTree::Node;
+
+    PathKeyWrapper(SystemType<ValueType>& system, std::shared_ptr<PathTree> tree = std::make_shared<PathTree>()) :
+        m_system(system),
+        m_tree(std::move(tree)),
+        m_nodes(makeProperty<Node>(system))
+    {
+        connectSignals();
+    }
+    // Clones get a copy of the tree, so names added to a clone do not reach the original.
+    PathKeyWrapper(const PathKeyWrapper& other, SystemType<ValueType>& system) :
+        PathKeyWrapper(other, system, std::make_shared<PathTree>(*other.m_tree))
+    {
+
+    }
+    // Clones onto the given copy of the tree of other, for wrappers that share a tree: it is copied
+    // once and every clone is given the copy.
+    PathKeyWrapper(const PathKeyWrapper& other, SystemType<ValueType>& system, std::shared_ptr<PathTree> tree) :
+        m_system(system),
+        m_tree(std::move(tree)),
+        m_nodes(other.m_nodes, system),
+        m_entities(other.m_entities)
+    {
+        connectSignals();
+    }
+    PathKeyWrapper(PathKeyWrapper&& other) :
+        m_system(other.m_system),
+        m_tree(std::move(other.m_tree)),
+        m_nodes(std::move(other.m_nodes)),
+        m_entities(std::move(other.m_entities))
+    {
+        other.m_onEraseConnection.disconnect();
+        other.m_onEraseManyConnection.disconnect();
+        connectSignals();
+    }
+
+    ValueType addOrGet(boost::string_view path)
+    {
+        return addOrGetAt(m_tree->addOrGet(path));
+    }
+    ValueType addOrGet(Node parent, boost::string_view segment)
+    {
+        return addOrGetAt(m_tree->addOrGetChild(parent, segment));
+    }
+    bool has(boost::string_view path) const
+    {
+        return entity(m_tree->find(path)) != PathTree::npos();
+    }
+    bool has(Node parent, boost::string_view segment) const
+    {
+        return entity(m_tree->child(parent, segment)) != PathTree::npos();
+    }
+    ValueType at(boost::string_view path) const
+    {
+        return at(m_tree->find(path));
+    }
+    ValueType at(Node parent, boost::string_view segment) const
+    {
+        return at(m_tree->child(parent, segment));
+    }
+    // Writes the entity of each child of parent named in segments to out, ValueType{} for the
+    // missing ones, looking the whole batch up at once (see PathTree::children).
+    template <class RangeType, class OutputIterator>
+    OutputIterator lookupBatch(Node parent, const RangeType& segments, OutputIterator out) const
+    {
+        m_tree->children(parent, segments, boost::make_function_output_iterator([&](Node node)
+        {
+            const std::size_t id = entity(node);
+            *out++ = id == PathTree::npos() ? ValueType{} : ValueType{id};
+        }));
+        return out;
+    }
+    Node node(ValueType en) const
+    {
+        return m_nodes[en];
+    }
+    boost::string_view segment(ValueType en) const
+    {
+        return m_tree->segment(m_nodes[en]);
+    }
+    std::string key(ValueType en) const
+    {
+        return m_tree->path(m_nodes[en]);
+    }
+    const PathTree& tree() const
+    {
+        return *m_tree;
+    }
+
+private:
+    static std::size_t nodeHash(Node node)
+    {
+        std::uint64_t hash = node * 0x9e3779b97f4a7c15ull;
+        hash ^= hash >> 32;
+        return static_cast<std::size_t>(hash);
+    }
+    std::size_t entity(Node node) const
+    {
+        if(node == PathTree::npos())
+        {
+            return PathTree::npos();
+        }
+        return m_entities.find(nodeHash(node), [&](std::size_t id)
+        {
+            return m_nodes[ValueType{id}] == node;
+        });
+    }
+    ValueType at(Node node) const
+    {
+        const std::size_t id = entity(node);
+        if(id == PathTree::npos())
+        {
+            throw std::out_of_range("PathKeyWrapper::at");
+        }
+        return ValueType{id};
+    }
+    ValueType addOrGetAt(Node node)
+    {
+        const std::size_t id = entity(node);
+        if(id != PathTree::npos())
+        {
+            return ValueType{id};
+        }
+        if(m_entities.full())
+        {
+            m_entities.grow();
+        }
+        ValueType en = m_system.get().add();
+        m_nodes[en] = node;
+        m_entities.insert(nodeHash(node), en.id());
+        return en;
+    }
+    void connectSignals()
+    {
+        m_nodes.disconnectOnErase();
+        m_onEraseConnection     = std::move(m_system.get().notifier->onErase.connect([this](ValueType en)
+        {
+            this->remove(en);
+            m_nodes.onErase(en);
+        }));
+        // remove() reads the node of the entity, so every entity leaves the table before the
+        // column is compacted.
+        m_onEraseManyConnection = std::move(m_system.get().notifier->onEraseMany.connect([this](const std::vector<ValueType>& entities)
+        {
+            for(ValueType en : entities)
+            {
+                this->remove(en);
+            }
+            m_nodes.onEraseMany(entities);
+        }));
+    }
+    void remove(ValueType en)
+    {
+        m_entities.erase(nodeHash(m_nodes[en]), [&](std::size_t id)
+        {
+            return id == en.id();
+        });
+    }
+
+    std::reference_wrapper<SystemType<ValueType>> m_system;
+    std::shared_ptr<PathTree>                     m_tree;
+    Property<ValueType, Node, SystemType>         m_nodes;
+    // Entity ids, hashed by their node.
+    KeyTable                                      m_entities;
+    boost::signals2::scoped_connection            m_onEraseConnection;
+    boost::signals2::scoped_connection            m_onEraseManyConnection;
+};
+
+template <typename ValueType, template <typename> class SystemType>
+PathKeyWrapper<ValueType, SystemType> makePathKeyWrapper(SystemType<ValueType>& system, std::shared_ptr<PathTree> tree = std::make_shared<PathTree>())
+{
+    return {system, std::move(tree)};
+}
+
+}
+
+#endif // PATHKEYWRAPPER_HPP
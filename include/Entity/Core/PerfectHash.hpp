@@ -0,0 +1,195 @@
+#ifndef PERFECTHASH_HPP
+#define PERFECTHASH_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+#include "KeyTable.hpp"
+
+namespace Entity
+{
+
+// Perfect hash over a fixed set of (hash, entity id) pairs, built with hash and displace: the
+// entries are split into buckets of about four, and each bucket, largest first, gets the first
+// seed that sends all of its entries to free slots. The slots are filled up to 99%, which keeps the
+// search for the last seeds short. A lookup reads the seed of its bucket and a single slot.
+class PerfectHash final
+{
+public:
+    using Slot = KeyTable::Slot;
+
+    PerfectHash() = default;
+    bool empty() const
+    {
+        return m_slots.empty();
+    }
+    std::size_t capacity() const
+    {
+        return m_slots.size();
+    }
+    void clear()
+    {
+        m_seeds.clear();
+        m_slots.clear();
+    }
+    // Builds the hash over the entries of table for which keep(id) holds. Returns false, leaving the
+    // hash empty, if no seed separates some bucket (e.g. two entries with the same full hash).
+    template <class Predicate>
+    bool build(const KeyTable& table, Predicate keep);
+    bool build(const KeyTable& table)
+    {
+        return build(table, [](std::size_t)
+        {
+            return true;
+        });
+    }
+    // Id of the entry with this hash for which equal(id) holds, npos() if there is none.
+    template <class Equal>
+    std::size_t find(std::size_t hash, Equal equal) const
+    {
+        if(m_slots.empty())
+        {
+            return npos();
+        }
+        const Slot& slot = m_slots[position(hash, m_seeds[bucket(hash)])];
+        return slot.id != npos() && slot.hash == hash && equal(slot.id) ? slot.id : npos();
+    }
+    // A lookup reads the seed of its bucket and then the slot it points to. Batched lookups call
+    // prefetchSeed for every hash, then prefetch, and only then find.
+    void prefetchSeed(std::size_t hash) const
+    {
+        if(!m_seeds.empty())
+        {
+            Entity::prefetch(&m_seeds[bucket(hash)]);
+        }
+    }
+    void prefetch(std::size_t hash) const
+    {
+        if(!m_slots.empty())
+        {
+            Entity::prefetch(&m_slots[position(hash, m_seeds[bucket(hash)])]);
+        }
+    }
+    void erase(std::size_t hash, std::size_t id)
+    {
+        if(m_slots.empty())
+        {
+            return;
+        }
+        Slot& slot = m_slots[position(hash, m_seeds[bucket(hash)])];
+        if(slot.id == id)
+        {
+            slot = Slot{0, npos()};
+        }
+    }
+    static constexpr std::size_t npos()
+    {
+        return KeyTable::npos();
+    }
+
+private:
+    static std::uint64_t mix(std::uint64_t x)
+    {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33;
+        return x;
+    }
+    std::size_t bucket(std::size_t hash) const
+    {
+        return mix(hash) % m_seeds.size();
+    }
+    std::size_t position(std::size_t hash, std::uint32_t seed) const
+    {
+        return mix(hash ^ (seed * 0x9e3779b97f4a7c15ull)) % m_slots.size();
+    }
+
+    std::vector<std::uint32_t> m_seeds;
+    std::vector<Slot>          m_slots;
+};
+
+template <class Predicate>
+bool PerfectHash::build(const KeyTable& table, Predicate keep)
+{
+    std::vector<Slot> entries;
+    entries.reserve(table.size());
+    table.forEach([&](const Slot& slot)
+    {
+        if(keep(slot.id))
+        {
+            entries.push_back(slot);
+        }
+    });
+    clear();
+    if(entries.empty())
+    {
+        return true;
+    }
+    m_seeds.assign((entries.size() + 3) / 4, 0);
+    m_slots.assign(entries.size() + entries.size() / 99 + 1, Slot{0, npos()});
+
+    // Group the entries by bucket and visit the buckets from the largest to the smallest.
+    std::sort(entries.begin(), entries.end(), [this](const Slot& first, const Slot& second)
+    {
+        return std::make_pair(bucket(first.hash), first.hash) < std::make_pair(bucket(second.hash), second.hash);
+    });
+    if(std::adjacent_find(entries.begin(), entries.end(), [](const Slot& first, const Slot& second){ return first.hash == second.hash; }) != entries.end())
+    {
+        clear();
+        return false;
+    }
+    std::vector<std::size_t> offsets(m_seeds.size() + 1, 0);
+    for(const Slot& entry : entries)
+    {
+        ++offsets[bucket(entry.hash) + 1];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<std::size_t> order(m_seeds.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t first, std::size_t second)
+    {
+        return offsets[first + 1] - offsets[first] > offsets[second + 1] - offsets[second];
+    });
+
+    std::vector<std::size_t> positions;
+    for(std::size_t current : order)
+    {
+        const auto first = entries.begin() + offsets[current];
+        const auto last  = entries.begin() + offsets[current + 1];
+        if(first == last)
+        {
+            break;
+        }
+        for(std::uint32_t seed = 1; ; ++seed)
+        {
+            if(seed == (1u << 24))
+            {
+                clear();
+                return false;
+            }
+            positions.clear();
+            bool placed = true;
+            for(auto entry = first; entry != last && placed; ++entry)
+            {
+                const std::size_t candidate = position(entry->hash, seed);
+                placed = m_slots[candidate].id == npos() && std::find(positions.begin(), positions.end(), candidate) == positions.end();
+                positions.push_back(candidate);
+            }
+            if(placed)
+            {
+                for(auto entry = first; entry != last; ++entry)
+                {
+                    m_slots[positions[entry - first]] = *entry;
+                }
+                m_seeds[current] = seed;
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+}
+
+#endif // PERFECTHASH_HPP
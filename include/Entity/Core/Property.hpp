@@ -14,6 +14,8 @@ public:
     Property(Property&& other);
     Property(const Property& other);
     Property(SystemType<KeyType>& sys);
+    // Clones other onto sys, a copy of the system other belongs to.
+    Property(const Property& other, SystemType<KeyType>& sys);
     ~Property() = default;
     Property& operator=(Property&& other);
     Property& operator=(const Property& other);
@@ -41,8 +43,10 @@ private:
     void connectSignals();
     void onAdd(KeyType);
     void onReserve(std::size_t size);
+    void onPermute(const std::vector<std::size_t>& from);
 public:
     void onErase(KeyType en);
+    void onEraseMany(const std::vector<KeyType>& entities);
 
 private:
     std::shared_ptr<typename SystemType<KeyType>::Indexer> m_indexer;
@@ -51,6 +55,8 @@ private:
     boost::signals2::scoped_connection                     m_onAddConnection;
     boost::signals2::scoped_connection                     m_onReserveConnection;
     boost::signals2::scoped_connection                     m_onEraseConnection;
+    boost::signals2::scoped_connection                     m_onEraseManyConnection;
+    boost::signals2::scoped_connection                     m_onPermuteConnection;
 };
 
 template <typename ValueType, typename KeyType, template <typename> class SystemType>
@@ -28,6 +28,14 @@ template <typename KeyType, typename ValueType, template <typename> class System
     connectSignals();
 }
 template <typename KeyType, typename ValueType, template <typename> class SystemType>
+Property<KeyType, ValueType, SystemType>::Property(const Property& other, SystemType<KeyType>& sys):
+    m_indexer(sys.indexer()),
+    m_notifier(sys.notifier),
+    m_values(other.m_values)
+{
+    connectSignals();
+}
+template <typename KeyType, typename ValueType, template <typename> class SystemType>
 Property<KeyType, ValueType, SystemType>& Property<KeyType, ValueType, SystemType>::operator=(Property&& other)
 {
     using std::swap;
@@ -84,6 +92,7 @@ template <typename KeyType, typename ValueType, template <typename> class System
 void Property<KeyType, ValueType, SystemType>::disconnectOnErase()
 {
     m_onEraseConnection.disconnect();
+    m_onEraseManyConnection.disconnect();
 }
 template <typename KeyType, typename ValueType, template <typename> class SystemType>
 template <class RangeType>
@@ -103,12 +112,31 @@ void Property<KeyType, ValueType, SystemType>::onReserve(std::size_t size)
     m_values.reserve(size);
 }
 template <typename KeyType, typename ValueType, template <typename> class SystemType>
+void Property<KeyType, ValueType, SystemType>::onPermute(const std::vector<std::size_t>& from)
+{
+    std::vector<ValueType> values;
+    values.reserve(m_values.capacity());
+    for(std::size_t index : from)
+    {
+        values.push_back(std::move(m_values[index]));
+    }
+    m_values.swap(values);
+}
+template <typename KeyType, typename ValueType, template <typename> class SystemType>
 void Property<KeyType, ValueType, SystemType>::onErase(KeyType en)
 {
     std::swap(m_values.back(), m_values[m_indexer->lookup(en)]);
     m_values.pop_back();
 }
 template <typename KeyType, typename ValueType, template <typename> class SystemType>
+void Property<KeyType, ValueType, SystemType>::onEraseMany(const std::vector<KeyType>& entities)
+{
+    for(KeyType en : entities)
+    {
+        onErase(en);
+    }
+}
+template <typename KeyType, typename ValueType, template <typename> class SystemType>
 void Property<KeyType, ValueType, SystemType>::connectSignals()
 {
     if(auto notifier = m_notifier.lock())
@@ -122,6 +150,12 @@ void Property<KeyType, ValueType, SystemType>::connectSignals()
         m_onEraseConnection   = std::move(notifier->onErase.connect([this](KeyType en) {
             this->onErase(en);
         }));
+        m_onEraseManyConnection = std::move(notifier->onEraseMany.connect([this](const std::vector<KeyType>& entities) {
+            this->onEraseMany(entities);
+        }));
+        m_onPermuteConnection = std::move(notifier->onPermute.connect([this](const std::vector<std::size_t>& from) {
+            this->onPermute(from);
+        }));
     }
 }
 
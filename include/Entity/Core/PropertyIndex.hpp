@@ -0,0 +1,209 @@
+#ifndef PROPERTYINDEX_HPP
+#define PROPERTYINDEX_HPP
+
+#include <map>
+#include <unordered_map>
+#include "Property.hpp"
+
+namespace Entity
+{
+
+// Selectors for the index container
+struct Ordered {};
+struct Hashed  {};
+
+// A secondary index from the values of a Property to the entities holding them. Writes must go
+// through the index (operator[] returns a tracked reference) so it stays in sync; added and erased
+// entities are tracked through the system signals. Entities sharing a value are kept contiguous,
+// so an equality query is a single lookup and its result a contiguous range.
+template <typename Selector, typename KeyType, typename ValueType, template <typename> class SystemType>
+class PropertyIndex final
+{
+    using Container = typename std::conditional<
+                        std::is_same<Selector, Ordered>::value,
+                        std::map<ValueType, std::vector<KeyType>>,
+                        std::unordered_map<ValueType, std::vector<KeyType>>
+                      >::type;
+    // Nodes of both containers are never relocated, so entities can point to their bucket.
+    using Bucket = typename Container::value_type;
+public:
+    class Reference
+    {
+    public:
+        Reference(PropertyIndex& index, KeyType key) :
+            m_index(index),
+            m_key(key)
+        {
+
+        }
+        Reference& operator=(ValueType value)
+        {
+            m_index.set(m_key, std::move(value));
+            return *this;
+        }
+        operator const ValueType&() const
+        {
+            return static_cast<const PropertyIndex&>(m_index)[m_key];
+        }
+    private:
+        PropertyIndex& m_index;
+        KeyType m_key;
+    };
+
+    PropertyIndex(SystemType<KeyType>& system, Property<KeyType, ValueType, SystemType>& property) :
+        m_property(property),
+        m_notifier(system.notifier),
+        m_bucket(makeProperty<Bucket*>(system)),
+        m_position(makeProperty<std::size_t>(system))
+    {
+        ranges::for_each(system.asRange(), [this](KeyType key)
+        {
+            this->insert(key);
+        });
+        connectSignals();
+    }
+    PropertyIndex(PropertyIndex&& other) :
+        m_property(other.m_property),
+        m_notifier(other.m_notifier),
+        m_buckets(std::move(other.m_buckets)),
+        m_bucket(std::move(other.m_bucket)),
+        m_position(std::move(other.m_position))
+    {
+        other.m_onAddConnection.disconnect();
+        other.m_onEraseConnection.disconnect();
+        other.m_onEraseManyConnection.disconnect();
+        connectSignals();
+    }
+    PropertyIndex(const PropertyIndex&) = delete;
+    PropertyIndex& operator=(const PropertyIndex&) = delete;
+
+    const ValueType& operator[](KeyType key) const
+    {
+        return m_property.get()[key];
+    }
+    Reference operator[](KeyType key)
+    {
+        return {*this, key};
+    }
+    void set(KeyType key, ValueType value)
+    {
+        if(m_property.get()[key] == value)
+        {
+            return;
+        }
+        remove(key);
+        m_property.get()[key] = std::move(value);
+        insert(key);
+    }
+    // Entities whose value is equal to value.
+    auto find(const ValueType& value) const
+    {
+        auto result = m_buckets.find(value);
+        if(result == m_buckets.end())
+        {
+            return ranges::make_iterator_range(m_empty.cbegin(), m_empty.cend());
+        }
+        return ranges::make_iterator_range(result->second.cbegin(), result->second.cend());
+    }
+    std::size_t count(const ValueType& value) const
+    {
+        auto result = m_buckets.find(value);
+        return result == m_buckets.end() ? 0 : result->second.size();
+    }
+    // Entities whose value is in [first, last), in value order. Only for Ordered indices.
+    auto range(const ValueType& first, const ValueType& last) const
+    {
+        static_assert(std::is_same<Selector, Ordered>::value, "Range queries need an Ordered index");
+        return ranges::make_iterator_range(m_buckets.lower_bound(first), m_buckets.lower_bound(last))
+             | ranges::view::transform([](const Bucket& bucket) -> const std::vector<KeyType>&
+               {
+                   return bucket.second;
+               })
+             | ranges::view::join;
+    }
+    // Number of distinct values.
+    std::size_t size() const
+    {
+        return m_buckets.size();
+    }
+
+private:
+    void connectSignals()
+    {
+        m_bucket.disconnectOnErase();
+        m_position.disconnectOnErase();
+        if(auto notifier = m_notifier.lock())
+        {
+            // The system calls the slots before updating its indexer, so the new entity is only
+            // reachable through its position: it is the last one, holding a default value.
+            m_onAddConnection   = std::move(notifier->onAdd.connect([this](KeyType key)
+            {
+                auto& bucket = this->bucket(ValueType{});
+                *(m_bucket.asRange().end() - 1)   = &bucket;
+                *(m_position.asRange().end() - 1) = bucket.second.size();
+                bucket.second.push_back(key);
+            }));
+            auto onErase = [this](KeyType key)
+            {
+                this->remove(key);
+                m_bucket.onErase(key);
+                m_position.onErase(key);
+            };
+            m_onEraseConnection     = std::move(notifier->onErase.connect(onErase));
+            // remove() writes the position of another entity, so every key leaves its bucket
+            // before the columns are compacted.
+            m_onEraseManyConnection = std::move(notifier->onEraseMany.connect([this](const std::vector<KeyType>& keys)
+            {
+                for(KeyType key : keys)
+                {
+                    this->remove(key);
+                }
+                m_bucket.onEraseMany(keys);
+                m_position.onEraseMany(keys);
+            }));
+        }
+    }
+    Bucket& bucket(const ValueType& value)
+    {
+        return *m_buckets.emplace(value, std::vector<KeyType>{}).first;
+    }
+    void insert(KeyType key)
+    {
+        auto& bucket = this->bucket(m_property.get()[key]);
+        m_bucket[key]   = &bucket;
+        m_position[key] = bucket.second.size();
+        bucket.second.push_back(key);
+    }
+    void remove(KeyType key)
+    {
+        Bucket& bucket = *m_bucket[key];
+        const std::size_t position = m_position[key];
+        m_position[bucket.second.back()] = position;
+        bucket.second[position] = bucket.second.back();
+        bucket.second.pop_back();
+        if(bucket.second.empty())
+        {
+            m_buckets.erase(m_buckets.find(bucket.first));
+        }
+    }
+
+    std::reference_wrapper<Property<KeyType, ValueType, SystemType>> m_property;
+    std::weak_ptr<typename SystemType<KeyType>::Notifier>            m_notifier;
+    Container                                                        m_buckets;
+    Property<KeyType, Bucket*, SystemType>                           m_bucket;
+    Property<KeyType, std::size_t, SystemType>                       m_position;
+    std::vector<KeyType>                                             m_empty;
+    boost::signals2::scoped_connection                               m_onAddConnection;
+    boost::signals2::scoped_connection                               m_onEraseConnection;
+    boost::signals2::scoped_connection                               m_onEraseManyConnection;
+};
+
+template <typename Selector, typename KeyType, typename ValueType, template <typename> class SystemType>
+PropertyIndex<Selector, KeyType, ValueType, SystemType> makeIndex(SystemType<KeyType>& system, Property<KeyType, ValueType, SystemType>& property)
+{
+    return {system, property};
+}
+
+}
+
+#endif // PROPERTYINDEX_HPP
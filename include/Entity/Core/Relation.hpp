@@ -0,0 +1,285 @@
+#ifndef RELATION_HPP
+#define RELATION_HPP
+
+#include <vector>
+#include "Property.hpp"
+#include "SystemWithDeletion.hpp"
+
+namespace Entity
+{
+
+// Many-to-many relation between the entities of two systems, e.g. pins and nets. Every edge is an
+// entity of a system owned by the relation, so edges can have properties of their own (see
+// edges()), and its endpoints and its links in the edge lists of both endpoints are stored in a
+// single record. The edge lists are doubly linked: adding and removing an edge are O(1), and
+// erasing an endpoint erases its edges.
+template <typename EdgeType, typename FromType, template <typename> class FromSystemType, typename ToType, template <typename> class ToSystemType>
+class Relation
+{
+public:
+    Relation(FromSystemType<FromType>& from, ToSystemType<ToType>& to):
+        m_edges(),
+        m_records(makeProperty<Record>(m_edges)),
+        m_from(makeProperty<Adjacency>(from)),
+        m_to(makeProperty<Adjacency>(to))
+    {
+        connectSignals(from, to);
+    }
+    // Clones other, and its edges, onto copies of its systems.
+    Relation(const Relation& other, FromSystemType<FromType>& from, ToSystemType<ToType>& to):
+        m_edges(other.m_edges),
+        m_records(other.m_records, m_edges),
+        m_from(other.m_from, from),
+        m_to(other.m_to, to)
+    {
+        connectSignals(from, to);
+    }
+    // The system of the edges, to make properties of them.
+    SystemWithDeletion<EdgeType>& edges()
+    {
+        return m_edges;
+    }
+    std::size_t size() const
+    {
+        return m_edges.size();
+    }
+    EdgeType connect(FromType from, ToType to)
+    {
+        const EdgeType edge = m_edges.add();
+        Record& record = m_records[edge];
+        record.from = from;
+        record.to   = to;
+        Adjacency& fromAdjacency = m_from[from];
+        record.nextFrom = fromAdjacency.first;
+        if(fromAdjacency.first != EdgeType{})
+        {
+            m_records[fromAdjacency.first].prevFrom = edge;
+        }
+        fromAdjacency.first = edge;
+        ++fromAdjacency.degree;
+        Adjacency& toAdjacency = m_to[to];
+        record.nextTo = toAdjacency.first;
+        if(toAdjacency.first != EdgeType{})
+        {
+            m_records[toAdjacency.first].prevTo = edge;
+        }
+        toAdjacency.first = edge;
+        ++toAdjacency.degree;
+        return edge;
+    }
+    // Connects every (from, to) pair of a forward range, with room for all the edges reserved at
+    // once.
+    template <class RangeType>
+    void connect(const RangeType& pairs)
+    {
+        m_edges.reserve(m_edges.size() + static_cast<std::size_t>(ranges::distance(pairs)));
+        for(const auto& pair : pairs)
+        {
+            connect(pair.first, pair.second);
+        }
+    }
+    void disconnect(EdgeType edge)
+    {
+        m_edges.erase(edge);
+    }
+    FromType from(EdgeType edge) const
+    {
+        return m_records[edge].from;
+    }
+    ToType to(EdgeType edge) const
+    {
+        return m_records[edge].to;
+    }
+    std::size_t degreeFrom(FromType from) const
+    {
+        return m_from[from].degree;
+    }
+    std::size_t degreeTo(ToType to) const
+    {
+        return m_to[to].degree;
+    }
+    // Edges of from, the last connected first.
+    auto edgesFrom(FromType from) const
+    {
+        return EdgesView<true>(*this, m_from[from].first);
+    }
+    auto edgesTo(ToType to) const
+    {
+        return EdgesView<false>(*this, m_to[to].first);
+    }
+    // Walks the edge list of one endpoint, through the from or the to links of the records.
+    template <bool FromSide>
+    class EdgesView
+      : public ranges::view_facade<EdgesView<FromSide>> {
+    private:
+        friend ranges::range_access;
+        const Relation* m_relation;
+        ranges::semiregular_t<EdgeType> m_current;
+        struct cursor
+        {
+        private:
+            EdgesView* m_range;
+        public:
+            cursor() = default;
+            explicit cursor(EdgesView& range)
+                : m_range(&range)
+            {}
+            void next()
+            {
+                m_range->next();
+            }
+            EdgeType& read() const noexcept
+            {
+                return m_range->current();
+            }
+            bool equal(ranges::default_sentinel) const
+            {
+                return m_range->current() == EdgeType{};
+            }
+            bool equal(const cursor& other) const
+            {
+                return read() == other.read();
+            }
+        };
+        void next()
+        {
+            const Record& record = m_relation->m_records[m_current];
+            m_current = FromSide ? record.nextFrom : record.nextTo;
+        }
+        cursor begin_cursor()
+        {
+            return cursor{*this};
+        }
+    public:
+        EdgesView() = default;
+        EdgesView(const Relation& relation, EdgeType first)
+            : m_relation(&relation),
+              m_current(first)
+        {
+        }
+        EdgeType& current()
+        {
+            return m_current;
+        }
+    };
+
+private:
+    struct Record
+    {
+        FromType from;
+        ToType   to;
+        EdgeType nextFrom;
+        EdgeType prevFrom;
+        EdgeType nextTo;
+        EdgeType prevTo;
+    };
+    struct Adjacency
+    {
+        EdgeType    first;
+        std::size_t degree = 0;
+    };
+
+    void unlink(EdgeType edge)
+    {
+        const Record& record = m_records[edge];
+        Adjacency& fromAdjacency = m_from[record.from];
+        if(record.prevFrom != EdgeType{})
+        {
+            m_records[record.prevFrom].nextFrom = record.nextFrom;
+        }
+        else
+        {
+            fromAdjacency.first = record.nextFrom;
+        }
+        if(record.nextFrom != EdgeType{})
+        {
+            m_records[record.nextFrom].prevFrom = record.prevFrom;
+        }
+        --fromAdjacency.degree;
+        Adjacency& toAdjacency = m_to[record.to];
+        if(record.prevTo != EdgeType{})
+        {
+            m_records[record.prevTo].nextTo = record.nextTo;
+        }
+        else
+        {
+            toAdjacency.first = record.nextTo;
+        }
+        if(record.nextTo != EdgeType{})
+        {
+            m_records[record.nextTo].prevTo = record.prevTo;
+        }
+        --toAdjacency.degree;
+    }
+    template <class AdjacencyType, class EntityType>
+    std::vector<EdgeType> edgesOf(const AdjacencyType& adjacency, const std::vector<EntityType>& entities, bool fromSide) const
+    {
+        std::vector<EdgeType> result;
+        for(EntityType en : entities)
+        {
+            for(EdgeType edge = adjacency[en].first; edge != EdgeType{}; edge = fromSide ? m_records[edge].nextFrom : m_records[edge].nextTo)
+            {
+                result.push_back(edge);
+            }
+        }
+        return result;
+    }
+    void connectSignals(FromSystemType<FromType>& from, ToSystemType<ToType>& to)
+    {
+        // Edges are unlinked, which writes the records of their neighbours, before any record goes.
+        m_records.disconnectOnErase();
+        m_onEraseEdgeConnection     = std::move(m_edges.notifier->onErase.connect([this](EdgeType edge)
+        {
+            unlink(edge);
+            m_records.onErase(edge);
+        }));
+        m_onEraseManyEdgeConnection = std::move(m_edges.notifier->onEraseMany.connect([this](const std::vector<EdgeType>& edges)
+        {
+            for(EdgeType edge : edges)
+            {
+                unlink(edge);
+            }
+            m_records.onEraseMany(edges);
+        }));
+        // The edges of an erased endpoint go first, while its adjacency is still in place.
+        auto onEraseFrom = [this](const std::vector<FromType>& entities)
+        {
+            m_edges.eraseMany(edgesOf(m_from, entities, true));
+        };
+        m_onEraseFromConnection = std::move(from.notifier->onErase.connect([onEraseFrom](FromType en)
+        {
+            onEraseFrom({en});
+        }, boost::signals2::at_front));
+        m_onEraseManyFromConnection = std::move(from.notifier->onEraseMany.connect(onEraseFrom, boost::signals2::at_front));
+        auto onEraseTo = [this](const std::vector<ToType>& entities)
+        {
+            m_edges.eraseMany(edgesOf(m_to, entities, false));
+        };
+        m_onEraseToConnection = std::move(to.notifier->onErase.connect([onEraseTo](ToType en)
+        {
+            onEraseTo({en});
+        }, boost::signals2::at_front));
+        m_onEraseManyToConnection = std::move(to.notifier->onEraseMany.connect(onEraseTo, boost::signals2::at_front));
+    }
+
+    SystemWithDeletion<EdgeType> m_edges;
+    Property<EdgeType, Record, SystemWithDeletion> m_records;
+    Property<FromType, Adjacency, FromSystemType> m_from;
+    Property<ToType, Adjacency, ToSystemType> m_to;
+    boost::signals2::scoped_connection m_onEraseEdgeConnection;
+    boost::signals2::scoped_connection m_onEraseManyEdgeConnection;
+    boost::signals2::scoped_connection m_onEraseFromConnection;
+    boost::signals2::scoped_connection m_onEraseManyFromConnection;
+    boost::signals2::scoped_connection m_onEraseToConnection;
+    boost::signals2::scoped_connection m_onEraseManyToConnection;
+};
+
+template <typename EdgeType, typename FromType, template <typename> class FromSystemType, typename ToType, template <typename> class ToSystemType>
+Relation<EdgeType, FromType, FromSystemType, ToType, ToSystemType> makeRelation(FromSystemType<FromType>& from, ToSystemType<ToType>& to)
+{
+    return {from, to};
+}
+
+}
+
+#endif // RELATION_HPP
@@ -0,0 +1,412 @@
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Entity
+{
+
+// Work-stealing thread pool. Each worker owns a deque: it pops its own tasks from the back and
+// steals from the front of the others. Threads that are not workers (e.g. the one waiting for a
+// frame) help by stealing until their condition is met, so nested waits never deadlock.
+class ThreadPool final
+{
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(std::size_t workers = std::thread::hardware_concurrency()) :
+        m_queues(std::max<std::size_t>(workers, 1)),
+        m_pending(0),
+        m_next(0),
+        m_done(false)
+    {
+        for(auto& queue : m_queues)
+        {
+            queue = std::make_unique<Queue>();
+        }
+        m_workers.reserve(workers);
+        for(std::size_t index = 0; index < workers; ++index)
+        {
+            m_workers.emplace_back([this, index]()
+            {
+                this->workerLoop(index);
+            });
+        }
+    }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_done = true;
+        }
+        m_wakeUp.notify_all();
+        for(auto& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+    std::size_t size() const
+    {
+        return m_workers.size();
+    }
+    void submit(Task task)
+    {
+        const std::size_t self = currentWorker();
+        Queue& queue = *m_queues[self != npos() ? self : m_next++ % m_queues.size()];
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            ++m_pending;
+        }
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        m_wakeUp.notify_one();
+    }
+    // Runs pending tasks on the calling thread until done() holds.
+    template <class Predicate>
+    void helpUntil(Predicate done)
+    {
+        Task task;
+        while(!done())
+        {
+            if(tryPop(currentWorker(), task))
+            {
+                task();
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+    // Calls body(begin, end) for every chunk of [first, last) and waits for all of them.
+    template <class Callable>
+    void parallelFor(std::size_t first, std::size_t last, std::size_t chunk, Callable body)
+    {
+        chunk = std::max<std::size_t>(chunk, 1);
+        if(last <= first + chunk)
+        {
+            if(first < last)
+            {
+                body(first, last);
+            }
+            return;
+        }
+        const std::size_t chunks = (last - first + chunk - 1) / chunk;
+        std::atomic<std::size_t> remaining{chunks - 1};
+        std::exception_ptr error;
+        std::mutex errorMutex;
+        for(std::size_t current = 1; current < chunks; ++current)
+        {
+            const std::size_t begin = first + current * chunk;
+            const std::size_t end   = std::min(begin + chunk, last);
+            submit([&, begin, end]()
+            {
+                try
+                {
+                    body(begin, end);
+                }
+                catch(...)
+                {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    error = std::current_exception();
+                }
+                --remaining;
+            });
+        }
+        try
+        {
+            body(first, first + chunk);
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            error = std::current_exception();
+        }
+        helpUntil([&]()
+        {
+            return remaining == 0;
+        });
+        if(error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex       mutex;
+        std::deque<Task> tasks;
+    };
+
+    static constexpr std::size_t npos()
+    {
+        return std::numeric_limits<std::size_t>::max();
+    }
+    // Index of the calling thread in this pool, npos() if it is not one of its workers.
+    std::size_t currentWorker() const
+    {
+        return currentThread().first == this ? currentThread().second : npos();
+    }
+    static std::pair<const ThreadPool*, std::size_t>& currentThread()
+    {
+        thread_local std::pair<const ThreadPool*, std::size_t> current{nullptr, npos()};
+        return current;
+    }
+    bool tryPop(std::size_t self, Task& task)
+    {
+        if(self != npos())
+        {
+            Queue& own = *m_queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if(!own.tasks.empty())
+            {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                --m_pending;
+                return true;
+            }
+        }
+        const std::size_t start = (self != npos() ? self + 1 : 0);
+        for(std::size_t offset = 0; offset < m_queues.size(); ++offset)
+        {
+            Queue& victim = *m_queues[(start + offset) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if(!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                --m_pending;
+                return true;
+            }
+        }
+        return false;
+    }
+    void workerLoop(std::size_t index)
+    {
+        currentThread() = {this, index};
+        Task task;
+        while(true)
+        {
+            if(tryPop(index, task))
+            {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_wakeUp.wait(lock, [this]()
+            {
+                return m_done || m_pending > 0;
+            });
+            if(m_done)
+            {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread>            m_workers;
+    std::mutex                          m_sleepMutex;
+    std::condition_variable             m_wakeUp;
+    std::atomic<std::size_t>            m_pending;
+    std::atomic<std::size_t>            m_next;
+    bool                                m_done;
+};
+
+// Runs a set of system updates once per frame. Every job declares the columns (Properties,
+// systems, or any other object, identified by address) it reads and writes; a job depends on every
+// earlier job it conflicts with (write/write, write/read or read/write), and independent jobs
+// run concurrently. Jobs which add or erase entities change every column of the system, so they
+// should be declared exclusive().
+class Scheduler final
+{
+public:
+    class Job final
+    {
+    public:
+        friend Scheduler;
+
+        template <class Callable>
+        explicit Job(Callable update) :
+            m_update(std::move(update)),
+            m_exclusive(false),
+            m_predecessors(0),
+            m_waiting(0)
+        {
+
+        }
+        template <class ColumnType>
+        Job& reads(const ColumnType& column)
+        {
+            m_reads.push_back(std::addressof(column));
+            return *this;
+        }
+        template <class ColumnType>
+        Job& writes(const ColumnType& column)
+        {
+            m_writes.push_back(std::addressof(column));
+            return *this;
+        }
+        Job& exclusive()
+        {
+            m_exclusive = true;
+            return *this;
+        }
+        bool conflicts(const Job& other) const
+        {
+            if(m_exclusive || other.m_exclusive)
+            {
+                return true;
+            }
+            auto intersects = [](const std::vector<const void*>& first, const std::vector<const void*>& second)
+            {
+                return std::find_first_of(first.begin(), first.end(), second.begin(), second.end()) != first.end();
+            };
+            return intersects(m_writes, other.m_writes) || intersects(m_writes, other.m_reads) || intersects(m_reads, other.m_writes);
+        }
+
+    private:
+        std::function<void()>    m_update;
+        std::vector<const void*> m_reads;
+        std::vector<const void*> m_writes;
+        bool                     m_exclusive;
+        std::vector<Job*>        m_successors;
+        std::size_t              m_predecessors;
+        std::atomic<std::size_t> m_waiting;
+    };
+
+    explicit Scheduler(std::size_t workers = std::thread::hardware_concurrency()) :
+        m_pool(workers)
+    {
+
+    }
+    template <class Callable>
+    Job& addJob(Callable update)
+    {
+        m_jobs.emplace_back(std::move(update));
+        return m_jobs.back();
+    }
+    std::size_t size() const
+    {
+        return m_jobs.size();
+    }
+    void clear()
+    {
+        m_jobs.clear();
+    }
+    ThreadPool& pool()
+    {
+        return m_pool;
+    }
+    template <class Callable>
+    void parallelFor(std::size_t first, std::size_t last, std::size_t chunk, Callable body)
+    {
+        m_pool.parallelFor(first, last, chunk, std::move(body));
+    }
+    // Builds this frame's dependency graph, runs every job and waits for all of them.
+    void run();
+
+private:
+    void release(Job& job);
+
+    ThreadPool               m_pool;
+    std::deque<Job>          m_jobs;
+    std::atomic<std::size_t> m_remaining;
+    std::exception_ptr       m_error;
+    std::mutex               m_errorMutex;
+};
+
+inline void Scheduler::run()
+{
+    for(auto& job : m_jobs)
+    {
+        job.m_successors.clear();
+        job.m_predecessors = 0;
+    }
+    for(auto second = m_jobs.begin(); second != m_jobs.end(); ++second)
+    {
+        for(auto first = m_jobs.begin(); first != second; ++first)
+        {
+            if(second->conflicts(*first))
+            {
+                first->m_successors.push_back(&*second);
+                ++second->m_predecessors;
+            }
+        }
+    }
+    m_error = nullptr;
+    m_remaining = m_jobs.size();
+    for(auto& job : m_jobs)
+    {
+        job.m_waiting = job.m_predecessors;
+    }
+    for(auto& job : m_jobs)
+    {
+        if(job.m_predecessors == 0)
+        {
+            m_pool.submit([this, &job]()
+            {
+                this->release(job);
+            });
+        }
+    }
+    m_pool.helpUntil([this]()
+    {
+        return m_remaining == 0;
+    });
+    if(m_error)
+    {
+        std::rethrow_exception(m_error);
+    }
+}
+
+inline void Scheduler::release(Job& job)
+{
+    bool failed;
+    {
+        std::lock_guard<std::mutex> lock(m_errorMutex);
+        failed = static_cast<bool>(m_error);
+    }
+    if(!failed)
+    {
+        try
+        {
+            job.m_update();
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(m_errorMutex);
+            m_error = std::current_exception();
+        }
+    }
+    for(Job* successor : job.m_successors)
+    {
+        if(--successor->m_waiting == 0)
+        {
+            m_pool.submit([this, successor]()
+            {
+                this->release(*successor);
+            });
+        }
+    }
+    --m_remaining;
+}
+
+}
+
+#endif // SCHEDULER_HPP
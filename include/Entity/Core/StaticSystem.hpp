@@ -0,0 +1,259 @@
+#ifndef STATICSYSTEM_HPP
+#define STATICSYSTEM_HPP
+
+#include <array>
+#include <stdexcept>
+#include "System.hpp"
+
+namespace Entity
+{
+
+template <typename EntityType, std::size_t N>
+class StaticSystem;
+
+// Hook through which a StaticSystem keeps its fixed-capacity properties in sync. The hooks form an
+// intrusive list, so registering a property allocates nothing.
+template <typename EntityType, std::size_t N>
+class StaticHook
+{
+public:
+    friend StaticSystem<EntityType, N>;
+
+protected:
+    StaticHook() :
+        m_next(nullptr)
+    {
+
+    }
+    virtual ~StaticHook() = default;
+    virtual void onAdd(std::size_t index) = 0;
+    virtual void onErase(std::size_t index, std::size_t last) = 0;
+
+private:
+    StaticHook* m_next;
+};
+
+// A system with deletion and a capacity fixed at compile time. All the bookkeeping lives in
+// std::array members, so a StaticSystem and its StaticProperties need no heap allocation and can
+// live on the stack. Ids of erased entities are reused, and add() throws std::length_error when the
+// system is full.
+template <typename EntityType, std::size_t N>
+class StaticSystem final
+{
+public:
+    friend StaticHook<EntityType, N>;
+    template <typename, typename, std::size_t>
+    friend class StaticProperty;
+    class Indexer
+    {
+    public:
+        friend StaticSystem;
+
+        constexpr Indexer() :
+            m_index{}
+        {
+
+        }
+        std::size_t lookup(EntityType en) const
+        {
+            return en.id() < N && m_index[en.id()] != 0 ? m_index[en.id()] - 1 : npos();
+        }
+
+    private:
+        void put(EntityType en, std::size_t index)
+        {
+            m_index[en.id()] = index + 1;
+        }
+
+        // Zero means not alive, so that a value-initialized indexer is valid.
+        std::array<std::size_t, N> m_index;
+    };
+
+    constexpr StaticSystem() :
+        m_ids{},
+        m_indexer{},
+        m_size(0),
+        m_allocated(0),
+        m_hooks(nullptr)
+    {
+
+    }
+    StaticSystem(const StaticSystem&) = delete;
+    StaticSystem& operator=(const StaticSystem&) = delete;
+    void reserve(std::size_t size)
+    {
+        if(size > N)
+        {
+            throw std::length_error("StaticSystem::reserve");
+        }
+    }
+    EntityType add()
+    {
+        if(m_size == N)
+        {
+            throw std::length_error("StaticSystem::add");
+        }
+        if(m_size == m_allocated)
+        {
+            m_ids[m_size] = m_allocated++;
+        }
+        const std::size_t id = m_ids[m_size];
+        m_indexer.put(EntityType{id}, m_size);
+        for(auto hook = m_hooks; hook != nullptr; hook = hook->m_next)
+        {
+            hook->onAdd(m_size);
+        }
+        ++m_size;
+        return EntityType{id};
+    }
+    void erase(EntityType entity)
+    {
+        const std::size_t index = m_indexer.lookup(entity);
+        if(index == npos())
+        {
+            throw std::out_of_range("StaticSystem::erase");
+        }
+        const std::size_t last = m_size - 1;
+        for(auto hook = m_hooks; hook != nullptr; hook = hook->m_next)
+        {
+            hook->onErase(index, last);
+        }
+        m_indexer.put(EntityType{m_ids[last]}, index);
+        m_indexer.m_index[entity.id()] = 0;
+        std::swap(m_ids[index], m_ids[last]);
+        --m_size;
+    }
+    constexpr std::size_t capacity() const
+    {
+        return N;
+    }
+    constexpr std::size_t size() const
+    {
+        return m_size;
+    }
+    constexpr bool empty() const
+    {
+        return m_size == 0;
+    }
+    bool alive(EntityType entity) const
+    {
+        return m_indexer.lookup(entity) != npos();
+    }
+    const Indexer& indexer() const
+    {
+        return m_indexer;
+    }
+    auto asRange() const
+    {
+        return ranges::make_iterator_range(m_ids.begin(), m_ids.begin() + m_size) | ranges::view::transform([](std::size_t id){ return EntityType{id}; });
+    }
+
+private:
+    static constexpr std::size_t npos()
+    {
+        return std::numeric_limits<std::size_t>::max();
+    }
+    void attach(StaticHook<EntityType, N>* hook)
+    {
+        hook->m_next = m_hooks;
+        m_hooks = hook;
+    }
+    void detach(StaticHook<EntityType, N>* hook)
+    {
+        for(auto current = &m_hooks; *current != nullptr; current = &(*current)->m_next)
+        {
+            if(*current == hook)
+            {
+                *current = hook->m_next;
+                return;
+            }
+        }
+    }
+
+    // Alive ids first, then the ids already handed out and free to be reused.
+    std::array<std::size_t, N>  m_ids;
+    Indexer                     m_indexer;
+    std::size_t                 m_size;
+    std::size_t                 m_allocated;
+    StaticHook<EntityType, N>*  m_hooks;
+};
+
+// A property of a StaticSystem backed by a std::array with the same capacity.
+template <typename KeyType, typename ValueType, std::size_t N>
+class StaticProperty final : private StaticHook<KeyType, N>
+{
+public:
+    StaticProperty(StaticSystem<KeyType, N>& system) :
+        m_system(system),
+        m_values{}
+    {
+        m_system.attach(this);
+    }
+    StaticProperty(StaticProperty&& other) :
+        m_system(other.m_system),
+        m_values(std::move(other.m_values))
+    {
+        m_system.attach(this);
+    }
+    StaticProperty(const StaticProperty&) = delete;
+    StaticProperty& operator=(const StaticProperty&) = delete;
+    ~StaticProperty()
+    {
+        m_system.detach(this);
+    }
+    constexpr std::size_t size() const
+    {
+        return m_system.size();
+    }
+    constexpr bool empty() const
+    {
+        return m_system.empty();
+    }
+    constexpr std::size_t capacity() const
+    {
+        return N;
+    }
+    ValueType& operator[](KeyType key)
+    {
+        return m_values[m_system.indexer().lookup(key)];
+    }
+    const ValueType& operator[](KeyType key) const
+    {
+        return m_values[m_system.indexer().lookup(key)];
+    }
+    auto asRange()
+    {
+        return ranges::make_iterator_range(m_values.begin(), m_values.begin() + size());
+    }
+    auto asRange() const
+    {
+        return ranges::make_iterator_range(m_values.cbegin(), m_values.cbegin() + size());
+    }
+    const ValueType* data() const
+    {
+        return m_values.data();
+    }
+
+private:
+    void onAdd(std::size_t index) override
+    {
+        m_values[index] = ValueType{};
+    }
+    void onErase(std::size_t index, std::size_t last) override
+    {
+        std::swap(m_values[index], m_values[last]);
+    }
+
+    StaticSystem<KeyType, N>& m_system;
+    std::array<ValueType, N>  m_values;
+};
+
+template <typename ValueType, typename KeyType, std::size_t N>
+StaticProperty<KeyType, ValueType, N> makeProperty(StaticSystem<KeyType, N>& system)
+{
+    return {system};
+}
+
+}
+
+#endif // STATICSYSTEM_HPP
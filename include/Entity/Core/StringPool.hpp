@@ -0,0 +1,73 @@
+#ifndef STRINGPOOL_HPP
+#define STRINGPOOL_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <boost/utility/string_view.hpp>
+
+namespace Entity
+{
+
+// Append-only arena for strings. The bytes are packed one after the other in fixed-size blocks
+// (a string longer than a block gets a block of its own) and never move, so the views returned by
+// append stay valid for the lifetime of the pool.
+class StringPool final
+{
+public:
+    explicit StringPool(std::size_t blockSize = 64 * 1024) :
+        m_blockSize(blockSize),
+        m_next(nullptr),
+        m_available(0),
+        m_bytes(0),
+        m_capacity(0)
+    {
+
+    }
+    StringPool(const StringPool&) = delete;
+    StringPool& operator=(const StringPool&) = delete;
+    boost::string_view append(boost::string_view str)
+    {
+        if(str.empty())
+        {
+            return {};
+        }
+        if(str.size() > m_available)
+        {
+            const std::size_t size = std::max(m_blockSize, str.size());
+            m_blocks.emplace_back(new char[size]);
+            m_next = m_blocks.back().get();
+            m_available = size;
+            m_capacity += size;
+        }
+        char* destination = m_next;
+        std::memcpy(destination, str.data(), str.size());
+        m_next      += str.size();
+        m_available -= str.size();
+        m_bytes     += str.size();
+        return {destination, str.size()};
+    }
+    // Bytes used by the strings.
+    std::size_t bytes() const
+    {
+        return m_bytes;
+    }
+    // Bytes allocated by the pool.
+    std::size_t capacity() const
+    {
+        return m_capacity;
+    }
+
+private:
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    std::size_t                          m_blockSize;
+    char*                                m_next;
+    std::size_t                          m_available;
+    std::size_t                          m_bytes;
+    std::size_t                          m_capacity;
+};
+
+}
+
+#endif // STRINGPOOL_HPP
@@ -1,6 +1,7 @@
 #ifndef SYSTEM_HPP
 #define SYSTEM_HPP
 
+#include <vector>
 #include <boost/signals2/dummy_mutex.hpp>
 #include <boost/signals2/signal.hpp>
 #include <boost/signals2/signal_type.hpp>
@@ -53,6 +54,12 @@ public:
     class Notifier;
     
     constexpr SystemBase();
+    // A copy has the same entities but a notifier of its own: nothing is connected to it until
+    // properties and compositions are cloned onto it.
+    SystemBase(const SystemBase& other);
+    SystemBase(SystemBase&&) = default;
+    SystemBase& operator=(const SystemBase&) = delete;
+    SystemBase& operator=(SystemBase&&) = default;
     virtual ~SystemBase() = default;
     void reserve(std::size_t size);
     EntityType add();
@@ -78,12 +85,24 @@ public:
     using OnAddSignal     = typename boost::signals2::signal_type<void(EntityType),  mutex_type>::type;
     using OnReserveSignal = typename boost::signals2::signal_type<void(std::size_t), mutex_type>::type;
     using OnEraseSignal   = typename boost::signals2::signal_type<void(EntityType),  mutex_type>::type;
+    using OnEraseManySignal = typename boost::signals2::signal_type<void(const std::vector<EntityType>&), mutex_type>::type;
+    using OnPermuteSignal = typename boost::signals2::signal_type<void(const std::vector<std::size_t>&), mutex_type>::type;
     
     ~Notifier() = default;
     
     OnAddSignal     onAdd;
     OnReserveSignal onReserve;
     OnEraseSignal   onErase;
+    // Bulk erase: the entities are distinct and sorted from the last dense index to the first, so
+    // a listener can remove them one by one, swapping each with its last element, and the index of
+    // the ones left to remove does not change. The system only updates its indexer afterwards, so
+    // the other entities moved by those swaps cannot be looked up until the slot returns: a
+    // listener that also writes data of other entities must do so before removing any. Whoever
+    // listens to onErase must listen to this too.
+    OnEraseManySignal onEraseMany;
+    // The dense order of the entities changed: the one now at index i was at index from[i]. The
+    // indexer still maps the entities to their old indices.
+    OnPermuteSignal onPermute;
     
 };
 
@@ -47,6 +47,12 @@ constexpr SystemBase<BaseType, EntityType>::SystemBase() :
 {
 }
 template <template <typename> class BaseType, class EntityType>
+SystemBase<BaseType, EntityType>::SystemBase(const SystemBase& other) :
+    notifier(std::make_shared<Notifier>()),
+    m_next(other.m_next)
+{
+}
+template <template <typename> class BaseType, class EntityType>
 void SystemBase<BaseType, EntityType>::reserve(std::size_t size)
 {
 	notifier->onReserve(size);
@@ -1,6 +1,9 @@
 #ifndef SYSTEMWITHDELETION_HPP
 #define SYSTEMWITHDELETION_HPP
 
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
 #include "System.hpp"
 
 namespace Entity
@@ -14,7 +17,20 @@ public:
     class Indexer;
 
     SystemWithDeletion();
+    SystemWithDeletion(const SystemWithDeletion& other);
+    SystemWithDeletion(SystemWithDeletion&&) = default;
+    SystemWithDeletion& operator=(SystemWithDeletion&&) = default;
+    // Erasing from a slot of this system's own erase signals, e.g. the cascade of a strong
+    // composition whose parents and children are in this system, is deferred: those entities are
+    // erased in another batch once the current one is compacted, so the indices of a batch never
+    // change under its listeners.
     void erase(EntityType entity);
+    // Erases a range of entities with a single onEraseMany. Dead and repeated entities are skipped.
+    template <class RangeType>
+    void eraseMany(const RangeType& entities);
+    // Reorders the entities, and every property of them, to the order of entities, which must hold
+    // every alive entity once. Throws std::invalid_argument if it does not.
+    void permute(const std::vector<EntityType>& entities);
 
 protected:
     constexpr std::size_t getSize() const;
@@ -26,8 +42,16 @@ protected:
     std::size_t getCapacity() const;
 
 private:
+    template <class RangeType>
+    void eraseBatch(const RangeType& entities);
+    template <class Callable>
+    void eraseDeferring(Callable eraseFirst);
+    void remove(EntityType entity);
+
     std::shared_ptr<Indexer> m_indexer;
     std::vector<EntityType>  m_entities;
+    bool                     m_erasing;
+    std::vector<EntityType>  m_pending;
 };
 
 template <class EntityType>
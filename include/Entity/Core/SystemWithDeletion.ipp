@@ -17,14 +17,133 @@ std::size_t SystemWithDeletion<EntityType>::Indexer::allocate()
 template <class EntityType>
 SystemWithDeletion<EntityType>::SystemWithDeletion() :
     SystemBase<::Entity::SystemWithDeletion, EntityType>(),
-    m_indexer(std::make_shared<Indexer>())
+    m_indexer(std::make_shared<Indexer>()),
+    m_erasing(false)
+{
+
+}
+template <class EntityType>
+SystemWithDeletion<EntityType>::SystemWithDeletion(const SystemWithDeletion& other) :
+    SystemBase<::Entity::SystemWithDeletion, EntityType>(other),
+    m_indexer(std::make_shared<Indexer>(*other.m_indexer)),
+    m_entities(other.m_entities),
+    m_erasing(false)
 {
 
 }
 template <class EntityType>
 void SystemWithDeletion<EntityType>::erase(EntityType entity)
 {
-    SystemBase<::Entity::SystemWithDeletion, EntityType>::notifier->onErase(entity);
+    if(m_erasing)
+    {
+        m_pending.push_back(entity);
+        return;
+    }
+    eraseDeferring([&]()
+    {
+        SystemBase<::Entity::SystemWithDeletion, EntityType>::notifier->onErase(entity);
+        remove(entity);
+    });
+}
+template <class EntityType>
+template <class RangeType>
+void SystemWithDeletion<EntityType>::eraseMany(const RangeType& entities)
+{
+    if(m_erasing)
+    {
+        for(EntityType entity : entities)
+        {
+            m_pending.push_back(entity);
+        }
+        return;
+    }
+    eraseDeferring([&]()
+    {
+        eraseBatch(entities);
+    });
+}
+template <class EntityType>
+template <class Callable>
+void SystemWithDeletion<EntityType>::eraseDeferring(Callable eraseFirst)
+{
+    m_erasing = true;
+    try
+    {
+        eraseFirst();
+        while(!m_pending.empty())
+        {
+            std::vector<EntityType> batch;
+            batch.swap(m_pending);
+            eraseBatch(batch);
+        }
+    }
+    catch(...)
+    {
+        m_erasing = false;
+        m_pending.clear();
+        throw;
+    }
+    m_erasing = false;
+}
+template <class EntityType>
+template <class RangeType>
+void SystemWithDeletion<EntityType>::eraseBatch(const RangeType& entities)
+{
+    std::vector<std::size_t> indices;
+    for(EntityType entity : entities)
+    {
+        if(isAlive(entity))
+        {
+            indices.push_back(m_indexer->lookup(entity));
+        }
+    }
+    std::sort(indices.begin(), indices.end(), std::greater<std::size_t>{});
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    if(indices.empty())
+    {
+        return;
+    }
+    std::vector<EntityType> erased;
+    erased.reserve(indices.size());
+    for(std::size_t index : indices)
+    {
+        erased.push_back(m_entities[index]);
+    }
+    SystemBase<::Entity::SystemWithDeletion, EntityType>::notifier->onEraseMany(erased);
+    for(EntityType entity : erased)
+    {
+        remove(entity);
+    }
+}
+template <class EntityType>
+void SystemWithDeletion<EntityType>::permute(const std::vector<EntityType>& entities)
+{
+    if(entities.size() != m_entities.size())
+    {
+        throw std::invalid_argument("SystemWithDeletion::permute");
+    }
+    std::vector<std::size_t> from;
+    from.reserve(entities.size());
+    std::vector<bool> taken(entities.size(), false);
+    for(EntityType entity : entities)
+    {
+        if(!isAlive(entity) || taken[m_indexer->lookup(entity)])
+        {
+            throw std::invalid_argument("SystemWithDeletion::permute");
+        }
+        from.push_back(m_indexer->lookup(entity));
+        taken[from.back()] = true;
+    }
+    SystemBase<::Entity::SystemWithDeletion, EntityType>::notifier->onPermute(from);
+    m_entities = entities;
+    for(std::size_t index = 0; index < m_entities.size(); ++index)
+    {
+        m_indexer->put(m_entities[index], index);
+    }
+}
+template <class EntityType>
+void SystemWithDeletion<EntityType>::remove(EntityType entity)
+{
     const std::size_t index = m_indexer->lookup(entity);
     EntityType& theEntity   = m_entities[index];
     EntityType& last        = m_entities.back();
@@ -0,0 +1,222 @@
+#ifndef TRAVERSAL_HPP
+#define TRAVERSAL_HPP
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+#include <range/v3/all.hpp>
+#include "Scheduler.hpp"
+
+namespace Entity
+{
+
+// Stack (or queue, for level order) of a traversal. Traversals never recurse, and a buffer reused
+// across traversals stops allocating once it has grown to the widest frontier it has seen (twice
+// that for level order, whose consumed prefix is dropped once it is half of the queue).
+template <typename NodeType>
+class TraversalBuffer final
+{
+public:
+    std::size_t capacity() const
+    {
+        return m_nodes.capacity();
+    }
+
+private:
+    template <typename, class, class>
+    friend class TraversalView;
+
+    // The flag marks the nodes whose children are already on the stack (postorder only).
+    std::vector<std::pair<NodeType, bool>> m_nodes;
+    std::size_t                            m_head = 0;
+};
+
+namespace Order
+{
+struct Pre   {};
+struct Post  {};
+struct Level {};
+}
+
+// Single-pass view over the nodes below a root, the root included. children(node) returns the
+// children of node, e.g. a composition whose parent and child systems are the same (see
+// childrenOf). The buffer is shared by the view, so only one traversal may use it at a time.
+template <typename NodeType, class ChildrenFunction, class OrderType>
+class TraversalView
+  : public ranges::view_facade<TraversalView<NodeType, ChildrenFunction, OrderType>> {
+private:
+    friend ranges::range_access;
+    TraversalBuffer<NodeType>* m_buffer = nullptr;
+    ranges::semiregular_t<ChildrenFunction> m_children;
+    ranges::semiregular_t<NodeType> m_current;
+    struct cursor
+    {
+    private:
+        TraversalView* m_range;
+    public:
+        cursor() = default;
+        explicit cursor(TraversalView& range)
+            : m_range(&range)
+        {}
+        void next()
+        {
+            m_range->next(OrderType{});
+        }
+        NodeType& read() const noexcept
+        {
+            return m_range->current();
+        }
+        bool equal(ranges::default_sentinel) const
+        {
+            return m_range->current() == NodeType{};
+        }
+        bool equal(const cursor& other) const
+        {
+            return read() == other.read();
+        }
+    };
+    // Pushes the children of node, reversed on a stack so that they pop in order.
+    void push(NodeType node, bool reversed)
+    {
+        auto& nodes = m_buffer->m_nodes;
+        const std::size_t first = nodes.size();
+        ranges::for_each(m_children(node), [&](NodeType child)
+        {
+            nodes.emplace_back(child, false);
+        });
+        if(reversed)
+        {
+            std::reverse(nodes.begin() + first, nodes.end());
+        }
+    }
+    void next(Order::Pre)
+    {
+        auto& nodes = m_buffer->m_nodes;
+        if(nodes.empty())
+        {
+            m_current = NodeType{};
+            return;
+        }
+        m_current = nodes.back().first;
+        nodes.pop_back();
+        push(m_current, true);
+    }
+    void next(Order::Post)
+    {
+        auto& nodes = m_buffer->m_nodes;
+        while(!nodes.empty() && !nodes.back().second)
+        {
+            nodes.back().second = true;
+            push(nodes.back().first, true);
+        }
+        if(nodes.empty())
+        {
+            m_current = NodeType{};
+            return;
+        }
+        m_current = nodes.back().first;
+        nodes.pop_back();
+    }
+    void next(Order::Level)
+    {
+        auto& nodes = m_buffer->m_nodes;
+        if(m_buffer->m_head == nodes.size())
+        {
+            m_current = NodeType{};
+            return;
+        }
+        m_current = nodes[m_buffer->m_head++].first;
+        if(2 * m_buffer->m_head > nodes.size())
+        {
+            nodes.erase(nodes.begin(), nodes.begin() + m_buffer->m_head);
+            m_buffer->m_head = 0;
+        }
+        push(m_current, false);
+    }
+    cursor begin_cursor()
+    {
+        return cursor{*this};
+    }
+public:
+    TraversalView() = default;
+    TraversalView(NodeType root, ChildrenFunction children, TraversalBuffer<NodeType>& buffer)
+        : m_buffer(&buffer),
+          m_children(std::move(children))
+    {
+        m_buffer->m_nodes.clear();
+        m_buffer->m_head = 0;
+        m_buffer->m_nodes.emplace_back(root, false);
+        next(OrderType{});
+    }
+    NodeType& current()
+    {
+        return m_current;
+    }
+};
+
+template <typename NodeType, class ChildrenFunction>
+TraversalView<NodeType, ChildrenFunction, Order::Pre> preorder(NodeType root, ChildrenFunction children, TraversalBuffer<NodeType>& buffer)
+{
+    return {root, std::move(children), buffer};
+}
+
+template <typename NodeType, class ChildrenFunction>
+TraversalView<NodeType, ChildrenFunction, Order::Post> postorder(NodeType root, ChildrenFunction children, TraversalBuffer<NodeType>& buffer)
+{
+    return {root, std::move(children), buffer};
+}
+
+template <typename NodeType, class ChildrenFunction>
+TraversalView<NodeType, ChildrenFunction, Order::Level> levelOrder(NodeType root, ChildrenFunction children, TraversalBuffer<NodeType>& buffer)
+{
+    return {root, std::move(children), buffer};
+}
+
+// Children function of a composition, which must outlive it.
+template <class CompositionType>
+auto childrenOf(const CompositionType& composition)
+{
+    return [&composition](auto node)
+    {
+        return composition.children(node);
+    };
+}
+
+// Calls visit(node) for every node below root, the root included, on the threads of pool. The top
+// levels are visited on the calling thread until there are a few independent subtrees per worker,
+// and each subtree is then walked in preorder by a single task, with a buffer of its own. Nodes of
+// one subtree are visited in preorder, with no order between subtrees. visit and children are called
+// concurrently, so e.g. a LeftMapped composition in auto freeze mode must be frozen beforehand.
+template <typename NodeType, class ChildrenFunction, class Visitor>
+void parallelTraverse(ThreadPool& pool, NodeType root, ChildrenFunction children, Visitor visit)
+{
+    const std::size_t wanted = 4 * std::max<std::size_t>(pool.size(), 1);
+    std::vector<NodeType> subtrees{root};
+    std::vector<NodeType> level;
+    while(!subtrees.empty() && subtrees.size() < wanted)
+    {
+        level.clear();
+        for(NodeType node : subtrees)
+        {
+            visit(node);
+            ranges::for_each(children(node), [&](NodeType child)
+            {
+                level.push_back(child);
+            });
+        }
+        subtrees.swap(level);
+    }
+    pool.parallelFor(0, subtrees.size(), 1, [&](std::size_t begin, std::size_t end)
+    {
+        TraversalBuffer<NodeType> buffer;
+        for(std::size_t index = begin; index < end; ++index)
+        {
+            ranges::for_each(preorder(subtrees[index], children, buffer), std::ref(visit));
+        }
+    });
+}
+
+}
+
+#endif // TRAVERSAL_HPP
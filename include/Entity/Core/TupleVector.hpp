@@ -1,8 +1,17 @@
 #ifndef TUPLEVECTOR_HPP
 #define TUPLEVECTOR_HPP
 
-#include <vector>
+#include <algorithm>
+#include <cstdint>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <range/v3/all.hpp>
 
 namespace Entity
 {
@@ -13,75 +22,404 @@ constexpr T integerCeilDivision(T x, T y)
     return (x % y == 0) ? x/y : (x/y) + 1;
 }
 
+// Rounds x up to a multiple of alignment, which must be a power of two.
+constexpr std::size_t alignUp(std::size_t x, std::size_t alignment)
+{
+    return (x + alignment - 1) & ~(alignment - 1);
+}
+
+// Allocates bytes starting on alignment, a power of two, and points data to them. The returned
+// storage owns the memory.
+inline std::unique_ptr<unsigned char[]> allocateAligned(std::size_t bytes, std::size_t alignment, unsigned char*& data)
+{
+    std::unique_ptr<unsigned char[]> storage(new unsigned char[bytes + alignment - 1]);
+    const auto address = reinterpret_cast<std::uintptr_t>(storage.get());
+    data = storage.get() + (alignUp(address, alignment) - address);
+    return storage;
+}
+
+// Column of T whose first element is aligned to Alignment bytes at least, e.g. Aligned<float, 64>
+// for a column read with aligned SIMD loads. Elements are still packed at sizeof(T).
+template<class T, std::size_t Alignment>
+struct Aligned
+{
+    static_assert(Alignment > 0 && (Alignment & (Alignment - 1)) == 0, "The alignment must be a power of two");
+};
+
+template<class T>
+struct ColumnTraits
+{
+    using Type = T;
+    static constexpr std::size_t alignment()
+    {
+        return alignof(T);
+    }
+};
+
+template<class T, std::size_t Alignment>
+struct ColumnTraits<Aligned<T, Alignment>>
+{
+    using Type = T;
+    static constexpr std::size_t alignment()
+    {
+        return std::max(Alignment, alignof(T));
+    }
+};
+
+// Byte layout of the first offset columns for a given capacity: each column starts at the end of
+// the previous one, rounded up to its alignment, in a buffer aligned to the largest of them.
 template<uint32_t offset, class ...Types>
 struct TupleVectorTraits
 {
-    using CurrentType = typename std::tuple_element<offset-1, std::tuple<Types...>>::type;
-    static constexpr std::size_t wordsNeeded(std::size_t numElements)
+    using Column      = ColumnTraits<typename std::tuple_element<offset-1, std::tuple<Types...>>::type>;
+    using CurrentType = typename Column::Type;
+    using Previous    = TupleVectorTraits<offset-1, Types...>;
+    static constexpr std::size_t alignment()
+    {
+        return std::max(Column::alignment(), Previous::alignment());
+    }
+    static constexpr std::size_t bytesNeeded(std::size_t capacity)
     {
-        const auto numWords = integerCeilDivision(numElements*sizeof(CurrentType), sizeof(uint32_t));
-        return numWords + TupleVectorTraits<offset-1, Types...>::wordsNeeded(numElements);
+        return lastByte(capacity);
     }
-    static constexpr std::size_t firstWord(std::size_t capacity)
+    static constexpr bool nothrowMovable()
     {
-        return TupleVectorTraits<offset-1, Types...>::lastWord(capacity);
+        return std::is_nothrow_move_constructible<CurrentType>::value && Previous::nothrowMovable();
     }
-    static constexpr std::size_t lastWord(std::size_t capacity)
+    static constexpr bool copyable()
+    {
+        return std::is_copy_constructible<CurrentType>::value && Previous::copyable();
+    }
+    static constexpr std::size_t firstByte(std::size_t capacity)
+    {
+        return alignUp(Previous::lastByte(capacity), Column::alignment());
+    }
+    static constexpr std::size_t lastByte(std::size_t capacity)
+    {
+        return firstByte(capacity) + capacity*sizeof(CurrentType);
+    }
+    static CurrentType* column(unsigned char* data, std::size_t capacity)
+    {
+        return reinterpret_cast<CurrentType*>(data + firstByte(capacity));
+    }
+    static const CurrentType* column(const unsigned char* data, std::size_t capacity)
+    {
+        return reinterpret_cast<const CurrentType*>(data + firstByte(capacity));
+    }
+    // The functions below run on rows [first, last) of every column. Those creating elements
+    // destroy what they created in the other columns if one of them throws.
+    static void construct(unsigned char* data, std::size_t capacity, std::size_t first, std::size_t last)
+    {
+        CurrentType* elements = column(data, capacity);
+        std::size_t index = first;
+        try
+        {
+            for(; index < last; ++index)
+            {
+                ::new (static_cast<void*>(elements + index)) CurrentType();
+            }
+            Previous::construct(data, capacity, first, last);
+        }
+        catch(...)
+        {
+            destroyColumn(elements, first, index);
+            throw;
+        }
+    }
+    static void destroy(unsigned char* data, std::size_t capacity, std::size_t first, std::size_t last)
+    {
+        destroyColumn(column(data, capacity), first, last);
+        Previous::destroy(data, capacity, first, last);
+    }
+    // Copy constructs the first size rows of a buffer of originCapacity rows into one of
+    // destinationCapacity rows.
+    static void copy(const unsigned char* origin, std::size_t originCapacity, unsigned char* destination, std::size_t destinationCapacity, std::size_t size)
+    {
+        const CurrentType* from = column(origin, originCapacity);
+        relocate(from, from + size, origin, originCapacity, destination, destinationCapacity, size, &Previous::copy);
+    }
+    // As copy, but moves the elements, which are left to be destroyed.
+    static void move(unsigned char* origin, std::size_t originCapacity, unsigned char* destination, std::size_t destinationCapacity, std::size_t size)
+    {
+        CurrentType* from = column(origin, originCapacity);
+        relocate(std::make_move_iterator(from), std::make_move_iterator(from + size), origin, originCapacity, destination, destinationCapacity, size, &Previous::move);
+    }
+    static void swapRows(unsigned char* data, std::size_t capacity, std::size_t first, std::size_t second)
+    {
+        using std::swap;
+        CurrentType* elements = column(data, capacity);
+        swap(elements[first], elements[second]);
+        Previous::swapRows(data, capacity, first, second);
+    }
+    // Move assigns row from to row to.
+    static void moveRow(unsigned char* data, std::size_t capacity, std::size_t from, std::size_t to)
+    {
+        CurrentType* elements = column(data, capacity);
+        elements[to] = std::move(elements[from]);
+        Previous::moveRow(data, capacity, from, to);
+    }
+
+private:
+    static void destroyColumn(CurrentType* elements, std::size_t first, std::size_t last)
     {
-        return TupleVectorTraits<offset, Types...>::firstWord(capacity) + integerCeilDivision(capacity*sizeof(CurrentType), sizeof(uint32_t));
+        for(std::size_t index = first; index < last; ++index)
+        {
+            elements[index].~CurrentType();
+        }
     }
-    static constexpr void copy(const std::vector<uint32_t>& origin, std::size_t originCapacity, std::vector<uint32_t>& destination, std::size_t destinationCapacity)
+    template <class Iterator, class Buffer, class Next>
+    static void relocate(Iterator begin, Iterator end, Buffer origin, std::size_t originCapacity, unsigned char* destination, std::size_t destinationCapacity, std::size_t size, Next next)
     {
-        const auto numWords = integerCeilDivision(originCapacity*sizeof(CurrentType), sizeof(uint32_t));
-        std::copy_backward(origin.begin() + firstWord(originCapacity), origin.begin() + lastWord(originCapacity), destination.begin() + firstWord(destinationCapacity) + numWords);
-        TupleVectorTraits<offset-1, Types...>::copy(origin, originCapacity, destination, destinationCapacity);
+        CurrentType* to = column(destination, destinationCapacity);
+        std::uninitialized_copy(begin, end, to);
+        try
+        {
+            next(origin, originCapacity, destination, destinationCapacity, size);
+        }
+        catch(...)
+        {
+            destroyColumn(to, 0, size);
+            throw;
+        }
     }
 };
 
 template<class ...Types>
 struct TupleVectorTraits<0, Types...>
 {
-    static constexpr std::size_t wordsNeeded(std::size_t)
+    static constexpr std::size_t alignment()
+    {
+        return 1;
+    }
+    static constexpr std::size_t bytesNeeded(std::size_t)
     {
         return 0;
     }
-    static constexpr std::size_t firstWord(std::size_t)
+    static constexpr bool nothrowMovable()
+    {
+        return true;
+    }
+    static constexpr bool copyable()
+    {
+        return true;
+    }
+    static constexpr std::size_t firstByte(std::size_t)
     {
         return 0;
     }
-    static constexpr std::size_t lastWord(std::size_t)
+    static constexpr std::size_t lastByte(std::size_t)
     {
         return 0;
     }
-    static constexpr void copy(const std::vector<uint32_t>&, std::size_t, std::vector<uint32_t>&, std::size_t)
+    static void construct(unsigned char*, std::size_t, std::size_t, std::size_t)
+    {
+
+    }
+    static void destroy(unsigned char*, std::size_t, std::size_t, std::size_t)
+    {
+
+    }
+    static void copy(const unsigned char*, std::size_t, unsigned char*, std::size_t, std::size_t)
+    {
+
+    }
+    static void move(unsigned char*, std::size_t, unsigned char*, std::size_t, std::size_t)
+    {
+
+    }
+    static void swapRows(unsigned char*, std::size_t, std::size_t, std::size_t)
+    {
+
+    }
+    static void moveRow(unsigned char*, std::size_t, std::size_t, std::size_t)
+    {
+
+    }
+};
+
+// Tuple of references to the elements of a row. Assigning or swapping rows assigns or swaps their
+// elements, so the standard algorithms can reorder rows through their iterators.
+template <class ... Elements>
+class TupleVectorRow : public std::tuple<Elements&...>
+{
+public:
+    using std::tuple<Elements&...>::tuple;
+    using std::tuple<Elements&...>::operator=;
+    friend void swap(TupleVectorRow first, TupleVectorRow second)
+    {
+        first.swap(second);
+    }
+};
+
+// Random access iterator over rows whose columns start at the given pointers. Dereferencing gives a
+// TupleVectorRow, so the columns are read and written in place.
+template <class ... Elements>
+class TupleVectorRowIterator
+{
+public:
+    using value_type        = std::tuple<std::remove_const_t<Elements>...>;
+    using reference         = TupleVectorRow<Elements...>;
+    using pointer           = void;
+    using difference_type   = std::ptrdiff_t;
+    using iterator_category = std::random_access_iterator_tag;
+
+    TupleVectorRowIterator() :
+        m_index(0)
+    {
+
+    }
+    TupleVectorRowIterator(std::tuple<Elements*...> columns, difference_type index) :
+        m_columns(columns),
+        m_index(index)
+    {
+
+    }
+    reference operator*() const
+    {
+        return row(std::index_sequence_for<Elements...>{});
+    }
+    reference operator[](difference_type offset) const
+    {
+        return *(*this + offset);
+    }
+    TupleVectorRowIterator& operator++()
+    {
+        ++m_index;
+        return *this;
+    }
+    TupleVectorRowIterator operator++(int)
     {
+        auto copy = *this;
+        ++m_index;
+        return copy;
+    }
+    TupleVectorRowIterator& operator--()
+    {
+        --m_index;
+        return *this;
+    }
+    TupleVectorRowIterator operator--(int)
+    {
+        auto copy = *this;
+        --m_index;
+        return copy;
+    }
+    TupleVectorRowIterator& operator+=(difference_type offset)
+    {
+        m_index += offset;
+        return *this;
+    }
+    TupleVectorRowIterator& operator-=(difference_type offset)
+    {
+        m_index -= offset;
+        return *this;
+    }
+    friend TupleVectorRowIterator operator+(TupleVectorRowIterator iterator, difference_type offset)
+    {
+        return iterator += offset;
+    }
+    friend TupleVectorRowIterator operator+(difference_type offset, TupleVectorRowIterator iterator)
+    {
+        return iterator += offset;
+    }
+    friend TupleVectorRowIterator operator-(TupleVectorRowIterator iterator, difference_type offset)
+    {
+        return iterator -= offset;
+    }
+    friend difference_type operator-(const TupleVectorRowIterator& first, const TupleVectorRowIterator& second)
+    {
+        return first.m_index - second.m_index;
+    }
+    friend bool operator==(const TupleVectorRowIterator& first, const TupleVectorRowIterator& second)
+    {
+        return first.m_index == second.m_index;
+    }
+    friend bool operator!=(const TupleVectorRowIterator& first, const TupleVectorRowIterator& second)
+    {
+        return first.m_index != second.m_index;
+    }
+    friend bool operator<(const TupleVectorRowIterator& first, const TupleVectorRowIterator& second)
+    {
+        return first.m_index < second.m_index;
+    }
+    friend bool operator>(const TupleVectorRowIterator& first, const TupleVectorRowIterator& second)
+    {
+        return first.m_index > second.m_index;
+    }
+    friend bool operator<=(const TupleVectorRowIterator& first, const TupleVectorRowIterator& second)
+    {
+        return first.m_index <= second.m_index;
+    }
+    friend bool operator>=(const TupleVectorRowIterator& first, const TupleVectorRowIterator& second)
+    {
+        return first.m_index >= second.m_index;
+    }
 
+private:
+    template <std::size_t ... Offsets>
+    reference row(std::index_sequence<Offsets...>) const
+    {
+        return reference{std::get<Offsets>(m_columns)[m_index]...};
     }
+
+    std::tuple<Elements*...> m_columns;
+    difference_type          m_index;
 };
 
+// Columns of Types, each contiguous, in a single buffer. A column can be declared Aligned<T, N> to
+// start on an N bytes boundary. Elements are constructed and destroyed with their rows, and moved to
+// the new buffer when it grows.
 template <class ... Types>
 class TupleVector
 {
+    using Traits = TupleVectorTraits<sizeof...(Types), Types...>;
 public:
+    template <uint32_t offset>
+    using ColumnType = typename ColumnTraits<typename std::tuple_element<offset, std::tuple<Types...>>::type>::Type;
+
     TupleVector(std::size_t size) :
-        m_actualSize(size),
-        m_capacity(size),
-        m_data(TupleVectorTraits<sizeof...(Types), Types...>::wordsNeeded(size))
+        TupleVector()
     {
+        reserve(size);
+        resize(size);
     }
     TupleVector():
         m_actualSize(0),
         m_capacity(0),
-        m_data(TupleVectorTraits<sizeof...(Types), Types...>::wordsNeeded(1))
+        m_data(nullptr),
+        m_columns()
     {
 
+    }
+    TupleVector(const TupleVector& other) :
+        TupleVector()
+    {
+        reserve(other.m_capacity);
+        Traits::copy(other.m_data, other.m_capacity, m_data, m_capacity, other.m_actualSize);
+        m_actualSize = other.m_actualSize;
+    }
+    TupleVector(TupleVector&& other) noexcept :
+        TupleVector()
+    {
+        swap(*this, other);
+    }
+    TupleVector& operator=(TupleVector other)
+    {
+        swap(*this, other);
+        return *this;
+    }
+    ~TupleVector()
+    {
+        Traits::destroy(m_data, m_capacity, 0, m_actualSize);
     }
     friend void swap(TupleVector& first, TupleVector& second)
     {
         using std::swap;
         swap(first.m_actualSize, second.m_actualSize);
         swap(first.m_capacity,   second.m_capacity);
-        first.m_data.swap(second.m_data);
+        swap(first.m_storage,    second.m_storage);
+        swap(first.m_data,       second.m_data);
+        swap(first.m_columns,    second.m_columns);
     }
     constexpr std::size_t size() const
     {
@@ -97,49 +435,208 @@ public:
     }
     void reserve(std::size_t newCapacity)
     {
-        m_data.resize(TupleVectorTraits<sizeof...(Types), Types...>::wordsNeeded(newCapacity));
-        TupleVectorTraits<sizeof...(Types), Types...>::copy(m_data, m_capacity, m_data, newCapacity);
-        m_capacity = newCapacity;
+        if(newCapacity <= m_capacity)
+        {
+            return;
+        }
+        unsigned char* data;
+        auto storage = allocateAligned(Traits::bytesNeeded(newCapacity), Traits::alignment(), data);
+        relocate(data, newCapacity);
+        adopt(std::move(storage), data, newCapacity);
     }
+    // Value-initializes the new rows, so trivial columns read zero, or destroys the dropped ones.
     void resize(std::size_t newSize)
     {
-        if(newSize <= m_capacity)
+        if(newSize > m_actualSize)
         {
-            m_actualSize = newSize;
+            grow(newSize);
+            Traits::construct(m_data, m_capacity, m_actualSize, newSize);
         }
         else
         {
-            reserve(std::max(1ul, m_capacity*2));
-            resize(newSize);
+            Traits::destroy(m_data, m_capacity, newSize, m_actualSize);
         }
+        m_actualSize = newSize;
     }
     void clear()
     {
         TupleVector<Types...> other;
         swap(*this, other);
     }
+    // Appends a row whose elements are constructed from one argument per column, or
+    // value-initialized without arguments.
+    template <class ... Args>
+    void emplace_back(Args&& ... args)
+    {
+        static_assert(sizeof...(Args) == 0 || sizeof...(Args) == sizeof...(Types), "emplace_back takes an argument per column");
+        if(m_actualSize < m_capacity)
+        {
+            constructRow<0>(m_data, m_capacity, std::forward<Args>(args)...);
+            ++m_actualSize;
+            return;
+        }
+        // The arguments may refer to rows of this vector, e.g. emplace_back(at<0>(0), at<1>(0)), so
+        // the new row is built in the new buffer before the old rows leave theirs.
+        const std::size_t newCapacity = grownCapacity(m_actualSize + 1);
+        unsigned char* data;
+        auto storage = allocateAligned(Traits::bytesNeeded(newCapacity), Traits::alignment(), data);
+        constructRow<0>(data, newCapacity, std::forward<Args>(args)...);
+        try
+        {
+            relocate(data, newCapacity);
+        }
+        catch(...)
+        {
+            Traits::destroy(data, newCapacity, m_actualSize, m_actualSize + 1);
+            throw;
+        }
+        adopt(std::move(storage), data, newCapacity);
+        ++m_actualSize;
+    }
+    void swapRows(std::size_t first, std::size_t second)
+    {
+        Traits::swapRows(m_data, m_capacity, first, second);
+    }
+    // Moves the last row onto index and drops it, so the order of the rows is not kept.
+    void eraseRow(std::size_t index)
+    {
+        const std::size_t last = m_actualSize - 1;
+        if(index != last)
+        {
+            Traits::moveRow(m_data, m_capacity, last, index);
+        }
+        Traits::destroy(m_data, m_capacity, last, m_actualSize);
+        m_actualSize = last;
+    }
     template <uint32_t offset>
-    void set(std::size_t index, typename std::tuple_element<offset, std::tuple<Types...>>::type value)
+    void set(std::size_t index, ColumnType<offset> value)
     {
-        using ValueType = typename std::tuple_element<offset, std::tuple<Types...>>::type;
-        auto addressOfTheFirstWord = std::addressof(m_data.data()[TupleVectorTraits<offset+1, Types...>::firstWord(m_capacity)]);
-        reinterpret_cast<ValueType*>(addressOfTheFirstWord)[index] = value;
+        columnData<offset>()[index] = std::move(value);
     }
     template <uint32_t offset>
-    typename std::tuple_element<offset, std::tuple<Types...>>::type at(std::size_t index) const
+    ColumnType<offset>& at(std::size_t index)
     {
-        using ValueType = typename std::tuple_element<offset, std::tuple<Types...>>::type;
-        return reinterpret_cast<const ValueType*>(std::addressof(m_data.data()[TupleVectorTraits<offset+1, Types...>::firstWord(m_capacity)]))[index];
+        return columnData<offset>()[index];
     }
-    const std::vector<uint32_t>& data() const
+    template <uint32_t offset>
+    const ColumnType<offset>& at(std::size_t index) const
+    {
+        return columnData<offset>()[index];
+    }
+    // Elements of a column, contiguous and aligned as declared.
+    template <uint32_t offset>
+    auto column()
+    {
+        return ranges::make_iterator_range(columnData<offset>(), columnData<offset>() + m_actualSize);
+    }
+    template <uint32_t offset>
+    auto column() const
+    {
+        const ColumnType<offset>* first = columnData<offset>();
+        return ranges::make_iterator_range(first, first + m_actualSize);
+    }
+    // Rows as tuples of references to their elements, e.g.
+    // ranges::for_each(vector.rows(), [](auto row){ std::get<1>(row) += std::get<0>(row); });
+    auto rows()
+    {
+        using Iterator = TupleVectorRowIterator<typename ColumnTraits<Types>::Type...>;
+        return ranges::make_iterator_range(Iterator(m_columns, 0), Iterator(m_columns, m_actualSize));
+    }
+    auto rows() const
+    {
+        using Iterator = TupleVectorRowIterator<const typename ColumnTraits<Types>::Type...>;
+        const std::tuple<const typename ColumnTraits<Types>::Type*...> constColumns = m_columns;
+        return ranges::make_iterator_range(Iterator(constColumns, 0), Iterator(constColumns, m_actualSize));
+    }
+    // Start of the buffer, aligned to the largest alignment of the columns.
+    const unsigned char* data() const
     {
         return m_data;
     }
 
 private:
-    std::size_t           m_actualSize;
-    std::size_t           m_capacity;
-    std::vector<uint32_t> m_data;
+    template <uint32_t offset>
+    ColumnType<offset>* columnData() const
+    {
+        return std::get<offset>(m_columns);
+    }
+    template <std::size_t ... Offsets>
+    std::tuple<typename ColumnTraits<Types>::Type*...> columns(std::index_sequence<Offsets...>) const
+    {
+        return std::make_tuple(TupleVectorTraits<Offsets+1, Types...>::column(m_data, m_capacity)...);
+    }
+    // Smallest power of two times the capacity that fits size.
+    std::size_t grownCapacity(std::size_t size) const
+    {
+        std::size_t newCapacity = std::max(1ul, m_capacity);
+        while(newCapacity < size)
+        {
+            newCapacity *= 2;
+        }
+        return newCapacity;
+    }
+    void grow(std::size_t size)
+    {
+        reserve(grownCapacity(size));
+    }
+    // Builds the rows in a buffer of newCapacity rows. As std::vector with std::move_if_noexcept,
+    // they are copied if a move could throw, so a throw leaves the rows of this buffer intact.
+    void relocate(unsigned char* data, std::size_t newCapacity)
+    {
+        relocate(data, newCapacity, std::integral_constant<bool, Traits::nothrowMovable() || !Traits::copyable()>{});
+    }
+    void relocate(unsigned char* data, std::size_t newCapacity, std::true_type)
+    {
+        Traits::move(m_data, m_capacity, data, newCapacity, m_actualSize);
+    }
+    void relocate(unsigned char* data, std::size_t newCapacity, std::false_type)
+    {
+        Traits::copy(m_data, m_capacity, data, newCapacity, m_actualSize);
+    }
+    // Destroys the rows of this buffer and takes data, whose rows are built, in its place.
+    void adopt(std::unique_ptr<unsigned char[]> storage, unsigned char* data, std::size_t newCapacity)
+    {
+        Traits::destroy(m_data, m_capacity, 0, m_actualSize);
+        m_storage  = std::move(storage);
+        m_data     = data;
+        m_capacity = newCapacity;
+        m_columns  = columns(std::index_sequence_for<Types...>{});
+    }
+    // Constructs row m_actualSize of a buffer of capacity rows.
+    template <uint32_t offset>
+    void constructRow(unsigned char* data, std::size_t capacity)
+    {
+        Traits::construct(data, capacity, m_actualSize, m_actualSize + 1);
+    }
+    template <uint32_t offset, class Arg>
+    void constructRow(unsigned char* data, std::size_t capacity, Arg&& arg)
+    {
+        ColumnType<offset>* elements = TupleVectorTraits<offset+1, Types...>::column(data, capacity);
+        ::new (static_cast<void*>(elements + m_actualSize)) ColumnType<offset>(std::forward<Arg>(arg));
+    }
+    template <uint32_t offset, class Arg, class Next, class ... Args>
+    void constructRow(unsigned char* data, std::size_t capacity, Arg&& arg, Next&& next, Args&& ... args)
+    {
+        using ValueType = ColumnType<offset>;
+        ValueType* element = TupleVectorTraits<offset+1, Types...>::column(data, capacity) + m_actualSize;
+        ::new (static_cast<void*>(element)) ValueType(std::forward<Arg>(arg));
+        try
+        {
+            constructRow<offset+1>(data, capacity, std::forward<Next>(next), std::forward<Args>(args)...);
+        }
+        catch(...)
+        {
+            element->~ValueType();
+            throw;
+        }
+    }
+
+    std::size_t                      m_actualSize;
+    std::size_t                      m_capacity;
+    std::unique_ptr<unsigned char[]> m_storage;
+    unsigned char*                   m_data;
+    // Start of each column, updated when the buffer grows.
+    std::tuple<typename ColumnTraits<Types>::Type*...> m_columns;
 
 };
 
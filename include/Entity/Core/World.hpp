@@ -0,0 +1,322 @@
+#ifndef WORLD_HPP
+#define WORLD_HPP
+
+#include <tuple>
+#include <utility>
+#include "Property.hpp"
+
+namespace Entity
+{
+
+template <typename EntityType, typename ... Components>
+class World;
+
+// Binds the component list so a World can be used where a template <typename> class SystemType is expected.
+template <typename ... Components>
+struct WorldOf
+{
+    template <typename EntityType>
+    using Type = World<EntityType, Components...>;
+};
+
+// Index of Component in Components..., used to access a column by type.
+template <typename Component, typename ... Components>
+struct ColumnIndex;
+
+template <typename Component, typename ... Components>
+struct ColumnIndex<Component, Component, Components...> : std::integral_constant<std::size_t, 0>
+{
+};
+
+template <typename Component, typename Other, typename ... Components>
+struct ColumnIndex<Component, Other, Components...> : std::integral_constant<std::size_t, 1 + ColumnIndex<Component, Components...>::value>
+{
+};
+
+// A system with deletion whose columns are known at compile time. The columns are kept in a tuple and
+// updated on add/erase by expanding over it, with no virtual call, and the index is held by value.
+// add and erase only fire the notifier when something is connected to it. Optional columns can
+// still be created with makeProperty: they share a copy of the index, kept in sync while they live.
+template <typename EntityType, typename ... Components>
+class World: public SystemBase<WorldOf<Components...>::template Type, EntityType>
+{
+public:
+    using Parent = SystemBase<WorldOf<Components...>::template Type, EntityType>;
+    friend Parent;
+    class Indexer;
+
+    World();
+    World(const World& other);
+    World& operator=(const World&) = delete;
+    World(World&&) = default;
+    World& operator=(World&&) = default;
+
+    EntityType add();
+    EntityType add(Components... values);
+    void erase(EntityType entity);
+
+    template <std::size_t Index>
+    auto& column();
+    template <std::size_t Index>
+    const auto& column() const;
+    template <typename Component>
+    std::vector<Component>& column();
+    template <typename Component>
+    const std::vector<Component>& column() const;
+
+    template <std::size_t Index>
+    auto& get(EntityType entity);
+    template <std::size_t Index>
+    const auto& get(EntityType entity) const;
+    template <typename Component>
+    Component& get(EntityType entity);
+    template <typename Component>
+    const Component& get(EntityType entity) const;
+
+protected:
+    constexpr std::size_t getSize() const;
+    auto getRange() const;
+    void doReserve(std::size_t size);
+    void doAdd();
+    bool isAlive(EntityType entity) const;
+    std::shared_ptr<Indexer> getIndexer() const;
+    std::size_t getCapacity() const;
+
+private:
+    template <std::size_t ... Indices>
+    void reserveColumns(std::size_t size, std::index_sequence<Indices...>);
+    template <std::size_t ... Indices>
+    void addToColumns(std::index_sequence<Indices...>);
+    template <std::size_t ... Indices>
+    void eraseFromColumns(std::size_t index, std::index_sequence<Indices...>);
+    template <std::size_t ... Indices>
+    void setColumns(std::size_t index, std::index_sequence<Indices...>, Components... values);
+    // Drops the shared copy of the index once only the world holds it.
+    void releaseShared();
+    void put(EntityType entity, std::size_t index);
+
+    Indexer                                  m_indexer;
+    // Copy of m_indexer for the properties, created on their first request.
+    mutable std::shared_ptr<Indexer>         m_shared;
+    std::vector<EntityType>                  m_entities;
+    std::tuple<std::vector<Components>...>   m_columns;
+};
+
+template <typename EntityType, typename ... Components>
+class World<EntityType, Components...>::Indexer
+{
+public:
+    friend World;
+
+    std::size_t lookup(EntityType en) const
+    {
+        return m_index.at(en.id());
+    }
+
+private:
+    std::vector<std::size_t> m_index;
+};
+
+template <typename EntityType, typename ... Components>
+World<EntityType, Components...>::World() :
+    Parent()
+{
+
+}
+template <typename EntityType, typename ... Components>
+World<EntityType, Components...>::World(const World& other) :
+    Parent(other),
+    m_indexer(other.m_indexer),
+    m_entities(other.m_entities),
+    m_columns(other.m_columns)
+{
+
+}
+template <typename EntityType, typename ... Components>
+EntityType World<EntityType, Components...>::add()
+{
+    if(!Parent::notifier->onAdd.empty())
+    {
+        return Parent::add();
+    }
+    const EntityType entity = Parent::m_next;
+    doAdd();
+    Parent::m_next = EntityType(entity.id() + 1);
+    return entity;
+}
+template <typename EntityType, typename ... Components>
+EntityType World<EntityType, Components...>::add(Components... values)
+{
+    const EntityType entity = add();
+    setColumns(m_entities.size() - 1, std::index_sequence_for<Components...>{}, std::move(values)...);
+    return entity;
+}
+template <typename EntityType, typename ... Components>
+void World<EntityType, Components...>::erase(EntityType entity)
+{
+    if(!Parent::notifier->onErase.empty())
+    {
+        Parent::notifier->onErase(entity);
+    }
+    releaseShared();
+    const std::size_t index = m_indexer.lookup(entity);
+    eraseFromColumns(index, std::index_sequence_for<Components...>{});
+    EntityType& theEntity = m_entities[index];
+    EntityType& last      = m_entities.back();
+    put(last, index);
+    put(entity, std::numeric_limits<std::size_t>::max());
+    std::swap(theEntity, last);
+    m_entities.pop_back();
+}
+template <typename EntityType, typename ... Components>
+template <std::size_t Index>
+auto& World<EntityType, Components...>::column()
+{
+    return std::get<Index>(m_columns);
+}
+template <typename EntityType, typename ... Components>
+template <std::size_t Index>
+const auto& World<EntityType, Components...>::column() const
+{
+    return std::get<Index>(m_columns);
+}
+template <typename EntityType, typename ... Components>
+template <typename Component>
+std::vector<Component>& World<EntityType, Components...>::column()
+{
+    return std::get<ColumnIndex<Component, Components...>::value>(m_columns);
+}
+template <typename EntityType, typename ... Components>
+template <typename Component>
+const std::vector<Component>& World<EntityType, Components...>::column() const
+{
+    return std::get<ColumnIndex<Component, Components...>::value>(m_columns);
+}
+template <typename EntityType, typename ... Components>
+template <std::size_t Index>
+auto& World<EntityType, Components...>::get(EntityType entity)
+{
+    return std::get<Index>(m_columns)[m_indexer.lookup(entity)];
+}
+template <typename EntityType, typename ... Components>
+template <std::size_t Index>
+const auto& World<EntityType, Components...>::get(EntityType entity) const
+{
+    return std::get<Index>(m_columns)[m_indexer.lookup(entity)];
+}
+template <typename EntityType, typename ... Components>
+template <typename Component>
+Component& World<EntityType, Components...>::get(EntityType entity)
+{
+    return column<Component>()[m_indexer.lookup(entity)];
+}
+template <typename EntityType, typename ... Components>
+template <typename Component>
+const Component& World<EntityType, Components...>::get(EntityType entity) const
+{
+    return column<Component>()[m_indexer.lookup(entity)];
+}
+template <typename EntityType, typename ... Components>
+constexpr std::size_t World<EntityType, Components...>::getSize() const
+{
+    return m_entities.size();
+}
+template <typename EntityType, typename ... Components>
+auto World<EntityType, Components...>::getRange() const
+{
+    return ranges::make_iterator_range(m_entities.begin(), m_entities.end());
+}
+template <typename EntityType, typename ... Components>
+void World<EntityType, Components...>::doReserve(std::size_t size)
+{
+    m_entities.reserve(size);
+    reserveColumns(size, std::index_sequence_for<Components...>{});
+}
+template <typename EntityType, typename ... Components>
+void World<EntityType, Components...>::doAdd()
+{
+    releaseShared();
+    m_indexer.m_index.push_back(m_entities.size());
+    if(m_shared)
+    {
+        m_shared->m_index.push_back(m_entities.size());
+    }
+    m_entities.emplace_back(m_indexer.m_index.size() - 1);
+    addToColumns(std::index_sequence_for<Components...>{});
+}
+template <typename EntityType, typename ... Components>
+bool World<EntityType, Components...>::isAlive(EntityType entity) const
+{
+    return entity != EntityType{} && m_indexer.lookup(entity) != std::numeric_limits<std::size_t>::max();
+}
+template <typename EntityType, typename ... Components>
+std::shared_ptr<typename World<EntityType, Components...>::Indexer> World<EntityType, Components...>::getIndexer() const
+{
+    if(!m_shared)
+    {
+        m_shared = std::make_shared<Indexer>(m_indexer);
+    }
+    return m_shared;
+}
+template <typename EntityType, typename ... Components>
+std::size_t World<EntityType, Components...>::getCapacity() const
+{
+    return m_entities.capacity();
+}
+template <typename EntityType, typename ... Components>
+template <std::size_t ... Indices>
+void World<EntityType, Components...>::reserveColumns(std::size_t size, std::index_sequence<Indices...>)
+{
+    using Expand = int[];
+    (void)Expand{0, (std::get<Indices>(m_columns).reserve(size), 0)...};
+}
+template <typename EntityType, typename ... Components>
+template <std::size_t ... Indices>
+void World<EntityType, Components...>::addToColumns(std::index_sequence<Indices...>)
+{
+    using Expand = int[];
+    (void)Expand{0, (std::get<Indices>(m_columns).emplace_back(), 0)...};
+}
+template <typename EntityType, typename ... Components>
+template <std::size_t ... Indices>
+void World<EntityType, Components...>::eraseFromColumns(std::size_t index, std::index_sequence<Indices...>)
+{
+    using std::swap;
+    using Expand = int[];
+    (void)Expand{0, (swap(std::get<Indices>(m_columns)[index], std::get<Indices>(m_columns).back()), std::get<Indices>(m_columns).pop_back(), 0)...};
+}
+template <typename EntityType, typename ... Components>
+template <std::size_t ... Indices>
+void World<EntityType, Components...>::setColumns(std::size_t index, std::index_sequence<Indices...>, Components... values)
+{
+    using Expand = int[];
+    (void)Expand{0, (std::get<Indices>(m_columns)[index] = std::move(values), 0)...};
+}
+
+template <typename EntityType, typename ... Components>
+void World<EntityType, Components...>::releaseShared()
+{
+    if(m_shared && m_shared.use_count() == 1)
+    {
+        m_shared.reset();
+    }
+}
+template <typename EntityType, typename ... Components>
+void World<EntityType, Components...>::put(EntityType entity, std::size_t index)
+{
+    m_indexer.m_index[entity.id()] = index;
+    if(m_shared)
+    {
+        m_shared->m_index[entity.id()] = index;
+    }
+}
+
+template <typename ValueType, typename EntityType, typename ... Components>
+Property<EntityType, ValueType, WorldOf<Components...>::template Type> makeProperty(World<EntityType, Components...>& world)
+{
+    return {world};
+}
+
+}
+
+#endif // WORLD_HPP
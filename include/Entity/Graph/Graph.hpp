@@ -43,6 +43,16 @@ public:
         m_outArcs(makeComposition<Both>(m_vertices, m_arcs))
     {
     }
+    // Forks other: vertices, arcs and adjacency are copied column by column. Properties of other
+    // are carried over with cloneVertexProperty and cloneArcProperty.
+    DigraphBase(const DigraphBase& other):
+        m_vertices(other.m_vertices),
+        m_arcs(other.m_arcs),
+        m_inArcs(other.m_inArcs, m_vertices, m_arcs),
+        m_outArcs(other.m_outArcs, m_vertices, m_arcs)
+    {
+    }
+    DigraphBase& operator=(const DigraphBase&) = delete;
     virtual ~DigraphBase()
     {}
     std::size_t order() const
@@ -118,6 +128,16 @@ public:
     {
         return makeProperty<ValueType>(m_arcs);
     }
+    template <class ValueType>
+    auto cloneVertexProperty(const Property<Vertex, ValueType, SystemType>& other)
+    {
+        return Property<Vertex, ValueType, SystemType>(other, m_vertices);
+    }
+    template <class ValueType>
+    auto cloneArcProperty(const Property<Arc, ValueType, SystemType>& other)
+    {
+        return Property<Arc, ValueType, SystemType>(other, m_arcs);
+    }
     auto vertices() const
     {
         return m_vertices.asRange();
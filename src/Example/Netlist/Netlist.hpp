@@ -2,8 +2,9 @@
 #define NETLIST_HPP
 
 #include <Entity/Core/SystemWithDeletion.hpp>
-#include <Entity/Core/KeyWrapper.hpp>
+#include <Entity/Core/PathKeyWrapper.hpp>
 #include <Entity/Core/Composition.hpp>
+#include <Entity/Core/Traversal.hpp>
 #include <boost/variant/get.hpp>
 
 ENTITY_ENTITY_DECLARATION(InputPort)
@@ -16,25 +17,31 @@ ENTITY_ENTITY_DECLARATION(MappedPort)
 template <typename EntityType>
 struct MappedSystem
 {
-    MappedSystem() :
+    MappedSystem(std::shared_ptr<Entity::PathTree> names) :
         system(),
-        map(system)
+        map(system, std::move(names))
+    {}
+    // names is the copy of the tree of other.
+    MappedSystem(const MappedSystem& other, std::shared_ptr<Entity::PathTree> names) :
+        system(other.system),
+        map(other.map, system, std::move(names))
     {}
 
     Entity::SystemWithDeletion<EntityType> system;
-    decltype(Entity::makeKeyWrapper<std::string>(system)) map;
+    Entity::PathKeyWrapper<EntityType, Entity::SystemWithDeletion> map;
 };
 
 class Netlist
 {
 public:
     Netlist() :
-        mDecls(),
-        mInputs(),
-        mOutputs(),
-        mInsts(),
+        mNames(std::make_shared<Entity::PathTree>()),
+        mDecls(mNames),
+        mInputs(mNames),
+        mOutputs(mNames),
+        mInsts(mNames),
         mInstsWeak(mInsts.system),
-        mWires(),
+        mWires(mNames),
         mMappedPort(),
         mMappedPortWeak(mMappedPort),
         mDeclWires(Entity::makeComposition<Entity::Both>(mDecls.system, mWires.system)),
@@ -47,46 +54,61 @@ public:
         mMappedPortsPorts(Entity::makeProperty<boost::variant<InputPort, OutputPort>>(mMappedPort))
     { }
 
+    Netlist(const Netlist& other) :
+        mNames(std::make_shared<Entity::PathTree>(*other.mNames)),
+        mDecls(other.mDecls, mNames),
+        mInputs(other.mInputs, mNames),
+        mOutputs(other.mOutputs, mNames),
+        mInsts(other.mInsts, mNames),
+        mInstsWeak(mInsts.system),
+        mWires(other.mWires, mNames),
+        mMappedPort(other.mMappedPort),
+        mMappedPortWeak(mMappedPort),
+        mDeclWires(other.mDeclWires, mDecls.system, mWires.system),
+        mDeclInsts(other.mDeclInsts, mDecls.system, mInstsWeak),
+        mDeclChildInsts(other.mDeclChildInsts, mDecls.system, mInstsWeak),
+        mDeclInputs(other.mDeclInputs, mDecls.system, mInputs.system),
+        mDeclOutputs(other.mDeclOutputs, mDecls.system, mOutputs.system),
+        mInstsMappedPorts(other.mInstsMappedPorts, mInsts.system, mMappedPort),
+        mWiresMappedPorts(other.mWiresMappedPorts, mWires.system, mMappedPortWeak),
+        mMappedPortsPorts(other.mMappedPortsPorts, mMappedPort),
+        mTopLevel(other.mTopLevel)
+    { }
+
     ModuleDecl addOrGetModuleDecl(std::string name)
     {
-        return mDecls.map.addOrGet(name);
+        return mDecls.map.addOrGet(Entity::PathTree::root(), name);
     }
 
-    MappedPort addOrGetInputPort(ModuleDecl module, std::string theName)
+    MappedPort addOrGetInputPort(ModuleDecl module, boost::string_view theName)
     {
-        auto port = mInputs.map.addOrGet(name(module) + "." + theName);
+        auto port = mInputs.map.addOrGet(mDecls.map.node(module), theName);
         if (mDeclInputs.parent(port) != module)
             mDeclInputs.addChild(module, port);
         return mapPort(ModuleInst{}, port, addOrGetWire(module, theName));
     }
 
-    MappedPort addOrGetOutputPort(ModuleDecl module, std::string theName)
+    MappedPort addOrGetOutputPort(ModuleDecl module, boost::string_view theName)
     {
-        auto port = mOutputs.map.addOrGet(name(module) + "." + theName);
+        auto port = mOutputs.map.addOrGet(mDecls.map.node(module), theName);
         if (mDeclOutputs.parent(port) != module)
             mDeclOutputs.addChild(module, port);
         return mapPort(ModuleInst{}, port, addOrGetWire(module, theName));
     }
 
-    ModuleInst addOrGetModuleInst(ModuleDecl parent, ModuleDecl decl, std::string theName)
+    ModuleInst addOrGetModuleInst(ModuleDecl parent, ModuleDecl decl, boost::string_view theName)
     {
         const bool orphan = parent == ModuleDecl{};
-        const std::string parentName = [&]() -> std::string
-        {
-            if (orphan)
-                return "";
-            return name(parent) + ".";
-        }();
-        auto inst = mInsts.map.addOrGet(parentName + theName);
+        auto inst = mInsts.map.addOrGet(orphan ? Entity::PathTree::root() : mDecls.map.node(parent), theName);
         mDeclInsts.addChild(decl, inst);
         if (!orphan)
             mDeclChildInsts.addChild(parent, inst);
         return inst;
     }
 
-    Wire addOrGetWire(ModuleDecl decl, std::string name)
+    Wire addOrGetWire(ModuleDecl decl, boost::string_view name)
     {
-        auto wire = mWires.map.addOrGet(mDecls.map.key(decl) + "." + name);
+        auto wire = mWires.map.addOrGet(mDecls.map.node(decl), name);
         if (mDeclWires.parent(wire) != decl)
             mDeclWires.addChild(decl, wire);
         return wire;
@@ -97,6 +119,22 @@ public:
         return mDeclChildInsts.children(decl);
     }
 
+    // Instances of the declaration of inst, i.e. its children in the design hierarchy.
+    auto children(ModuleInst inst) const
+    {
+        return mDeclChildInsts.children(decl(inst));
+    }
+
+    // The instances below root in preorder. An instance of a declaration that is instantiated more
+    // than once shows up once per instantiation path.
+    auto hierarchy(ModuleInst root, Entity::TraversalBuffer<ModuleInst>& buffer) const
+    {
+        return Entity::preorder(root, [this](ModuleInst inst)
+        {
+            return children(inst);
+        }, buffer);
+    }
+
     ModuleDecl parent(ModuleInst inst) const
     {
         return mDeclChildInsts.parent(inst);
@@ -107,32 +145,32 @@ public:
         return mDeclInsts.parent(inst);
     }
 
-    const std::string& name(ModuleInst inst) const
+    std::string name(ModuleInst inst) const
     {
         return mInsts.map.key(inst);
     }
 
-    const std::string& name(ModuleDecl decl) const
+    std::string name(ModuleDecl decl) const
     {
         return mDecls.map.key(decl);
     }
 
-    const std::string& name(Wire wire) const
+    std::string name(Wire wire) const
     {
         return mWires.map.key(wire);
     }
 
-    const std::string& name(InputPort port) const
+    std::string name(InputPort port) const
     {
         return mInputs.map.key(port);
     }
 
-    const std::string& name(OutputPort port) const
+    std::string name(OutputPort port) const
     {
         return mOutputs.map.key(port);
     }
 
-    const std::string& name(boost::variant<InputPort, OutputPort> port) const
+    std::string name(boost::variant<InputPort, OutputPort> port) const
     {
         if (port.type() == typeid(InputPort))
             return name(boost::get<InputPort>(port));
@@ -182,18 +220,8 @@ public:
     void topLevel(ModuleInst inst)
     {
         mTopLevel = inst;
-        ranges::for_each(inputPorts(decl(inst)), [&](InputPort port)
-        {
-            auto portName = name(port);
-            portName = portName.substr(portName.find_last_of(".") + 1);
-            mapPort(inst, port, addOrGetWire(decl(inst), portName));
-        });
-        ranges::for_each(outputPorts(decl(inst)), [&](OutputPort port)
-        {
-            auto portName = name(port);
-            portName = portName.substr(portName.find_last_of(".") + 1);
-            mapPort(inst, port, addOrGetWire(decl(inst), portName));
-        });
+        mapTopLevelPorts(inst, inputPorts(decl(inst)), mInputs.map);
+        mapTopLevelPorts(inst, outputPorts(decl(inst)), mOutputs.map);
     }
 
     ModuleInst topLevel() const
@@ -264,7 +292,38 @@ public:
         return mInstsMappedPorts.parent(port);
     }
 
+    const Entity::PathTree& names() const
+    {
+        return *mNames;
+    }
+
 private:
+    // The wires of the ports usually exist already, so they are looked up in one batch.
+    template <typename PortsType, typename MapType>
+    void mapTopLevelPorts(ModuleInst inst, PortsType ports, const MapType& map)
+    {
+        using PortType = std::decay_t<decltype(*ranges::begin(ports))>;
+        const ModuleDecl module = decl(inst);
+        std::vector<PortType> thePorts;
+        std::vector<boost::string_view> names;
+        ranges::for_each(ports, [&](PortType port)
+        {
+            thePorts.push_back(port);
+            names.push_back(map.segment(port));
+        });
+        std::vector<Wire> wires;
+        wires.reserve(names.size());
+        mWires.map.lookupBatch(mDecls.map.node(module), names, std::back_inserter(wires));
+        for (std::size_t index = 0; index < thePorts.size(); ++index)
+        {
+            const Wire wire = wires[index] != Wire{} ? wires[index] : addOrGetWire(module, names[index]);
+            mapPort(inst, thePorts[index], wire);
+        }
+    }
+
+    // Names are stored as a tree shared by all the systems, so "decl.wire" only stores "wire" and
+    // points to the node of "decl".
+    std::shared_ptr<Entity::PathTree> mNames;
     MappedSystem<ModuleDecl> mDecls;
     MappedSystem<InputPort> mInputs;
     MappedSystem<OutputPort> mOutputs;
@@ -67,6 +67,28 @@ TEST_CASE("Add output")
     CHECK(nl.wiresSize(decl) == 1);
 }
 
+TEST_CASE("Copy")
+{
+    Netlist nl;
+    auto decl = nl.addOrGetModuleDecl("decl");
+    auto inp = nl.addOrGetInputPort(decl, "inp");
+    Netlist copy(nl);
+    const auto nodes = nl.names().size();
+    const auto bytes = nl.names().bytes();
+    auto out = copy.addOrGetOutputPort(decl, "out");
+    CHECK(nl.names().size() == nodes);
+    CHECK(nl.names().bytes() == bytes);
+    CHECK(copy.names().size() == nodes + 1);
+    CHECK(copy.name(copy.port(inp)) == "decl.inp");
+    CHECK(copy.name(copy.port(out)) == "decl.out");
+    CHECK(copy.wiresSize(decl) == 2);
+    CHECK(nl.wiresSize(decl) == 1);
+    CHECK(nl.outputPortsSize(decl) == 0);
+    CHECK(nl.addOrGetModuleDecl("decl") == decl);
+    nl.addOrGetWire(decl, "other");
+    CHECK(copy.names().size() == nodes + 1);
+}
+
 TEST_CASE("Hierarchical Buffer")
 {
     /*
@@ -185,3 +207,23 @@ TEST_CASE("4 bit adder")
         });
     });
 }
+
+TEST_CASE("Hierarchy traversal")
+{
+    Netlist nl;
+    auto leafDecl = nl.addOrGetModuleDecl("LEAF");
+    auto midDecl = nl.addOrGetModuleDecl("MID");
+    auto topDecl = nl.addOrGetModuleDecl("TOP");
+    nl.addOrGetModuleInst(midDecl, leafDecl, "l0");
+    nl.addOrGetModuleInst(midDecl, leafDecl, "l1");
+    nl.addOrGetModuleInst(topDecl, midDecl, "m0");
+    nl.addOrGetModuleInst(topDecl, midDecl, "m1");
+    auto top = nl.addOrGetModuleInst(ModuleDecl{}, topDecl, "top");
+    Entity::TraversalBuffer<ModuleInst> buffer;
+    std::vector<std::string> names;
+    ranges::for_each(nl.hierarchy(top, buffer), [&](ModuleInst inst)
+    {
+        names.push_back(nl.name(inst));
+    });
+    CHECK(names == (std::vector<std::string>{"top", "TOP.m1", "MID.l1", "MID.l0", "TOP.m0", "MID.l1", "MID.l0"}));
+}
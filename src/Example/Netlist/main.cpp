@@ -76,7 +76,7 @@ public:
 
     Pin addOrGetPin(CellInst cell, std::string name)
     {
-        auto fullName = m_cellInstsMap.key(cell) + ":" + std::move(name);
+        auto fullName = m_cellInstsMap.key(cell).to_string() + ":" + std::move(name);
         auto pin = m_pinsMap.addOrGet(fullName);
         m_cellsPins.addChild(cell, pin);
         return pin;
@@ -109,17 +109,17 @@ public:
 
     std::string name(Pin pin) const
     {
-        return m_pinsMap.key(pin);
+        return m_pinsMap.key(pin).to_string();
     }
 
     std::string name(CellInst cell) const
     {
-        return m_cellInstsMap.key(cell);
+        return m_cellInstsMap.key(cell).to_string();
     }
 
     std::string name(Net net) const
     {
-        return m_netsMap.key(net);
+        return m_netsMap.key(net).to_string();
     }
 
 private:
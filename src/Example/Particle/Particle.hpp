@@ -3,6 +3,7 @@
 
 #include <Entity/Core/SystemWithDeletion.hpp>
 #include <Entity/Core/Property.hpp>
+#include <Entity/Core/Scheduler.hpp>
 #include <SFML/Graphics.hpp>
 
 namespace Example
@@ -68,7 +69,56 @@ public:
           m_data(Entity::makeProperty<Data>(m_sys)),
           m_life(Entity::makeProperty<uint8_t>(m_sys)),
           m_view(m_sys)
-    {}
+    {
+        // Life and position touch disjoint columns, so they run concurrently.
+        m_scheduler.addJob([this]()
+        {
+            ranges::for_each(m_life.asRange(), [](std::uint8_t& qnt)
+            {
+                --qnt;
+            });
+        }).writes(m_life);
+
+        m_scheduler.addJob([this]()
+        {
+            auto data = m_data.asRange();
+            m_scheduler.parallelFor(0, m_data.size(), 4096, [&](std::size_t begin, std::size_t end)
+            {
+                std::for_each(data.begin() + begin, data.begin() + end, [](Data& particle)
+                {
+                    particle.update();
+                });
+            });
+        }).writes(m_data);
+
+        // Kill dead entities
+        m_scheduler.addJob([this]()
+        {
+            m_toKill = m_sys.asRange() | ranges::view::filter([&](Particle par)
+            {
+                return m_life[par] == 0;
+            });
+
+            ranges::for_each(m_toKill, [&](Particle par)
+            {
+                m_sys.erase(par);
+            });
+
+            m_toKill.resize(0);
+        }).exclusive();
+
+        // Update shapes
+        m_scheduler.addJob([this]()
+        {
+            ranges::for_each(ranges::view::zip(m_view.property.asRange(), m_data.asRange(), m_life.asRange()), [&](std::tuple<ParticleContour&, const Data&, const uint8_t> tuple)
+            {
+                ParticleContour& shape           = std::get<0>(tuple);
+                const Data& data                 = std::get<1>(tuple);
+                const uint8_t life               = std::get<2>(tuple);
+                shape.set(data.pos, sf::Color{255, static_cast<sf::Uint8>(255-life), 0});
+            });
+        }).reads(m_data).reads(m_life).writes(m_view.property);
+    }
     void addParticles(uint32_t num, sf::Vector2f position)
     {
         std::uniform_real_distribution<float> velocityDistribution{-10.0, 10.0};
@@ -96,36 +146,7 @@ public:
 
     void update()
     {
-        // Update life
-        ranges::for_each(m_life.asRange(), [](std::uint8_t& qnt)
-        {
-            --qnt;
-        });
-
-        // Kill dead entities
-        m_toKill = m_sys.asRange() | ranges::view::filter([&](Particle par)
-        {
-            return m_life[par] == 0;
-        });
-
-        ranges::for_each(m_toKill, [&](Particle par)
-        {
-            m_sys.erase(par);
-        });
-
-        m_toKill.resize(0);
-
-        // Update position
-        ranges::for_each(m_data.asRange(), &Data::update);
-
-        // Update shapes
-        ranges::for_each(ranges::view::zip(m_view.property.asRange(), m_data.asRange(), m_life.asRange()), [&](std::tuple<ParticleContour&, const Data&, const uint8_t> tuple)
-        {
-            ParticleContour& shape           = std::get<0>(tuple);
-            const Data& data                 = std::get<1>(tuple);
-            const uint8_t life               = std::get<2>(tuple);
-            shape.set(data.pos, sf::Color{255, static_cast<sf::Uint8>(255-life), 0});
-        });
+        m_scheduler.run();
     }
 
     void draw(sf::RenderWindow& window) const
@@ -141,6 +162,7 @@ private:
     std::random_device m_randomDevice;
 
     std::vector<Particle> m_toKill;
+    Entity::Scheduler m_scheduler;
 };
 
 }
@@ -0,0 +1,143 @@
+#include <catch.hpp>
+#include <Entity/Core/Composition.hpp>
+#include <Entity/Core/KeyWrapper.hpp>
+#include <Entity/Core/PathKeyWrapper.hpp>
+#include <Entity/Core/World.hpp>
+#include <Entity/Graph/Graph.hpp>
+#include "test.hpp"
+#include "HierarchyTest.hpp"
+
+using namespace Entity;
+
+TEST_CASE("Clone system and property", "[Clone]")
+{
+    Test::Fixture::WithThreeEntitiesEraseFirst<SystemWithDeletion> fixture;
+    auto values = makeProperty<int>(fixture.system);
+    values[fixture.entity[1]] = 1;
+    values[fixture.entity[2]] = 2;
+
+    auto system = fixture.system;
+    auto clonedValues = Property<Test::TestEntity, int, SystemWithDeletion>(values, system);
+    CHECK(system.size() == 2);
+    CHECK(!system.alive(fixture.entity[0]));
+    CHECK(clonedValues[fixture.entity[1]] == 1);
+    CHECK(clonedValues[fixture.entity[2]] == 2);
+
+    system.erase(fixture.entity[1]);
+    auto added = system.add();
+    clonedValues[added] = 3;
+    CHECK(clonedValues.size() == 2);
+    CHECK(clonedValues[fixture.entity[2]] == 2);
+    CHECK(clonedValues[added] == 3);
+
+    CHECK(fixture.system.size() == 2);
+    CHECK(fixture.system.alive(fixture.entity[1]));
+    CHECK(values.size() == 2);
+    CHECK(values[fixture.entity[1]] == 1);
+}
+
+TEST_CASE("Clone composition", "[Clone]")
+{
+    auto parentSystem = SystemWithDeletion<Test::Parent>{};
+    auto childSystem  = SystemWithDeletion<Test::Child>{};
+    auto composition  = makeComposition<Both>(parentSystem, childSystem);
+    auto parent = parentSystem.add();
+    auto child  = childSystem.add();
+    auto child2 = childSystem.add();
+    composition.addChild(parent, child);
+    composition.addChild(parent, child2);
+
+    auto parentCopy = parentSystem;
+    auto childCopy  = childSystem;
+    decltype(composition) compositionCopy(composition, parentCopy, childCopy);
+    CHECK(compositionCopy.childrenSize(parent) == 2);
+    CHECK(compositionCopy.parent(child) == parent);
+
+    childCopy.erase(child2);
+    CHECK(compositionCopy.childrenSize(parent) == 1);
+    CHECK(compositionCopy.firstChild(parent) == child);
+    CHECK(composition.childrenSize(parent) == 2);
+
+    parentCopy.erase(parent);
+    CHECK(childCopy.empty());
+    CHECK(childSystem.size() == 2);
+    CHECK(composition.parent(child2) == parent);
+}
+
+TEST_CASE("Clone key wrappers", "[Clone]")
+{
+    auto system = SystemWithDeletion<Test::TestEntity>{};
+    auto keys   = makeKeyWrapper<std::string>(system);
+    auto paths  = makePathKeyWrapper(system);
+    const auto en = keys.addOrGet("first");
+    const auto path = paths.addOrGet("top.first");
+
+    auto copy      = system;
+    auto copyKeys  = decltype(keys)(keys, copy);
+    auto copyPaths = decltype(paths)(paths, copy);
+    const auto poolBytes = keys.pool().bytes();
+    const auto treeBytes = paths.tree().bytes();
+    const auto nodes     = paths.tree().size();
+    copyKeys.addOrGet("second");
+    copyPaths.addOrGet("top.second");
+    CHECK(keys.pool().bytes() == poolBytes);
+    CHECK(paths.tree().bytes() == treeBytes);
+    CHECK(paths.tree().size() == nodes);
+    CHECK(copyKeys.key(en) == "first");
+    CHECK(copyPaths.key(path) == "top.first");
+
+    keys.addOrGet("third");
+    paths.addOrGet("top.third");
+    CHECK(!copyKeys.has("third"));
+    CHECK(copyPaths.tree().size() == nodes + 1);
+    CHECK(keys.key(en) == "first");
+}
+
+TEST_CASE("Fork digraph", "[Clone]")
+{
+    Graph::Digraph d;
+    auto u = d.addVertex();
+    auto v = d.addVertex();
+    auto w = d.addVertex();
+    auto uv = d.addArc(u, v);
+    auto weights = d.makeArcProperty<double>();
+    weights[uv] = 1.5;
+
+    Graph::Digraph fork(d);
+    auto forkWeights = fork.cloneArcProperty(weights);
+    auto vw = fork.addArc(v, w);
+    forkWeights[vw] = 2.5;
+    fork.erase(u);
+    CHECK(fork.order() == 2);
+    CHECK(fork.size() == 1);
+    CHECK(fork.target(vw) == w);
+    CHECK(forkWeights[vw] == 2.5);
+
+    CHECK(d.order() == 3);
+    CHECK(d.size() == 1);
+    CHECK(d.outDegree(u) == 1);
+    CHECK(d.inDegree(v) == 1);
+    CHECK(weights.size() == 1);
+    CHECK(weights[uv] == 1.5);
+}
+
+TEST_CASE("Clone world", "[Clone]")
+{
+    World<Test::TestEntity, int, double> world;
+    auto first  = world.add(1, 1.5);
+    auto second = world.add(2, 2.5);
+    auto names  = makeProperty<std::string>(world);
+    names[second] = "second";
+
+    auto copy = world;
+    auto copyNames = Property<Test::TestEntity, std::string, WorldOf<int, double>::Type>(names, copy);
+    copy.erase(first);
+    copy.get<int>(second) = 3;
+    CHECK(copy.size() == 1);
+    CHECK(copy.get<double>(second) == 2.5);
+    CHECK(copyNames[second] == "second");
+    CHECK(world.size() == 2);
+    CHECK(world.get<int>(first) == 1);
+    CHECK(world.get<int>(second) == 2);
+    CHECK(names[second] == "second");
+}
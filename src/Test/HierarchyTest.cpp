@@ -1,11 +1,16 @@
 #include <catch.hpp>
 #include <Entity/Core/Composition.hpp>
+#include <Entity/Core/EulerTourIndex.hpp>
+#include <Entity/Core/Relation.hpp>
 #include <Entity/Core/SystemWithDeletion.hpp>
+#include <Entity/Core/Traversal.hpp>
 
 #include "HierarchyTest.hpp"
 
 using namespace Entity;
 
+ENTITY_ENTITY_DECLARATION(TestEdge)
+
 TEST_CASE("Mapping interface", "[Hierarchy]")
 {
     {
@@ -284,3 +289,635 @@ TEST_CASE("Add/Remove child", "[Hierarchy]")
         test(parentSystem, childSystem, makeComposition<Left>(parentSystem, childSystem));
     }
 }
+
+TEST_CASE("Freeze", "[Hierarchy]")
+{
+    auto test = [](auto&& parentSystem, auto&& childSystem, auto composition)
+    {
+        auto parent0 = parentSystem.add();
+        auto parent1 = parentSystem.add();
+        auto parent2 = parentSystem.add();
+        std::vector<Test::Child> children0, children2;
+        for(int i = 0; i < 5; ++i)
+        {
+            children0.push_back(childSystem.add());
+            composition.addChild(parent0, children0.back());
+            children2.push_back(childSystem.add());
+            composition.addChild(parent2, children2.back());
+        }
+        auto children = [&](Test::Parent parent)
+        {
+            std::vector<Test::Child> result;
+            for_each(composition.children(parent), [&](Test::Child child)
+            {
+                result.push_back(child);
+            });
+            return result;
+        };
+        const auto linked0 = children(parent0);
+        const auto linked2 = children(parent2);
+        CHECK(!composition.frozen());
+        composition.freeze();
+        CHECK(composition.frozen());
+        CHECK(children(parent0) == linked0);
+        CHECK(distance(composition.children(parent1)) == 0);
+        CHECK(children(parent2) == linked2);
+
+        composition.removeChild(parent2, children2.front());
+        CHECK(!composition.frozen());
+        CHECK(count(composition.children(parent2), children2.front()) == 0);
+        CHECK(composition.childrenSize(parent2) == 4);
+
+        composition.autoFreeze(true);
+        composition.children(parent0);
+        composition.children(parent1);
+        CHECK(!composition.frozen());
+        composition.children(parent2);
+        CHECK(composition.frozen());
+        CHECK(children(parent0) == linked0);
+        CHECK(count(composition.children(parent2), children2.front()) == 0);
+        composition.addChild(parent1, childSystem.add());
+        CHECK(!composition.frozen());
+        CHECK(distance(composition.children(parent1)) == 1);
+    };
+    {
+        SystemWithDeletion<Test::Parent> parentSystem;
+        SystemWithDeletion<Test::Child> childSystem;
+        test(parentSystem, childSystem, makeComposition<Both>(parentSystem, childSystem));
+    }
+    {
+        SystemWithDeletion<Test::Parent> parentSystem;
+        SystemWithDeletion<Test::Child> childSystem;
+        test(parentSystem, childSystem, makeComposition<Left>(parentSystem, childSystem));
+    }
+    {
+        SystemWithDeletion<Test::Parent> parentSystem;
+        SystemWithDeletion<Test::Child> childSystem;
+        auto composition = makeComposition<Left>(parentSystem, childSystem);
+        auto parent = parentSystem.add();
+        auto child  = childSystem.add();
+        composition.addChild(parent, child);
+        composition.freeze();
+        parentSystem.erase(parent);
+        CHECK(!composition.frozen());
+        CHECK(!childSystem.alive(child));
+    }
+}
+
+TEST_CASE("Doubly linked siblings", "[Hierarchy]")
+{
+    auto test = [](auto&& parentSystem, auto&& childSystem, auto composition)
+    {
+        auto parent = parentSystem.add();
+        std::vector<Test::Child> added;
+        for(int i = 0; i < 5; ++i)
+        {
+            added.push_back(childSystem.add());
+            composition.addChild(parent, added.back());
+        }
+        // The list is c4 c3 c2 c1 c0.
+        CHECK(composition.prevSibling(added[4]) == Test::Child{});
+        CHECK(composition.prevSibling(added[2]) == added[3]);
+        composition.removeChild(parent, added[2]);
+        CHECK(composition.nextSibling(added[3]) == added[1]);
+        CHECK(composition.prevSibling(added[1]) == added[3]);
+        composition.removeChild(parent, added[4]);
+        CHECK(composition.firstChild(parent) == added[3]);
+        CHECK(composition.prevSibling(added[3]) == Test::Child{});
+        composition.removeChild(parent, added[0]);
+        CHECK(composition.nextSibling(added[1]) == Test::Child{});
+        CHECK(composition.childrenSize(parent) == 2);
+        CHECK(distance(composition.children(parent)) == 2);
+    };
+    {
+        SystemWithDeletion<Test::Parent> parentSystem;
+        SystemWithDeletion<Test::Child> childSystem;
+        test(parentSystem, childSystem, makeComposition<Both>(parentSystem, childSystem));
+    }
+    {
+        SystemWithDeletion<Test::Parent> parentSystem;
+        SystemWithDeletion<Test::Child> childSystem;
+        test(parentSystem, childSystem, makeComposition<DoublyLinkedLeft>(parentSystem, childSystem));
+    }
+    {
+        SystemWithDeletion<Test::Parent> parentSystem;
+        SystemWithDeletion<Test::Child> childSystem;
+        auto composition = makeComposition<Both>(parentSystem, childSystem);
+        auto parent = parentSystem.add();
+        std::vector<Test::Child> added;
+        for(int i = 0; i < 100; ++i)
+        {
+            added.push_back(childSystem.add());
+            composition.addChild(parent, added.back());
+        }
+        for(int i = 1; i < 100; i += 2)
+        {
+            childSystem.erase(added[i]);
+        }
+        CHECK(composition.childrenSize(parent) == 50);
+        std::vector<Test::Child> remaining;
+        for_each(composition.children(parent), [&](Test::Child child)
+        {
+            remaining.push_back(child);
+        });
+        REQUIRE(remaining.size() == 50);
+        bool linked = composition.prevSibling(remaining.front()) == Test::Child{};
+        for(std::size_t i = 1; i < remaining.size(); ++i)
+        {
+            linked = linked && composition.prevSibling(remaining[i]) == remaining[i - 1];
+            linked = linked && remaining[i].id() % 2 == 0;
+        }
+        CHECK(linked);
+    }
+}
+
+TEST_CASE("Small vector children", "[Hierarchy]")
+{
+    {
+        SystemWithDeletion<Test::Parent> parentSystem;
+        SystemWithDeletion<Test::Child> childSystem;
+        auto composition = makeComposition<SmallLeft<2>>(parentSystem, childSystem);
+        auto parent0 = parentSystem.add();
+        auto parent1 = parentSystem.add();
+        std::vector<Test::Child> added;
+        for(int i = 0; i < 9; ++i)
+        {
+            added.push_back(childSystem.add());
+            composition.addChild(parent0, added.back());
+        }
+        composition.addChild(parent1, childSystem.add());
+        CHECK(composition.childrenSize(parent0) == 9);
+        CHECK(composition.childrenSize(parent1) == 1);
+        CHECK(std::equal(added.begin(), added.end(), composition.children(parent0).begin()));
+        composition.removeChild(parent0, added[4]);
+        added.erase(added.begin() + 4);
+        CHECK(composition.childrenSize(parent0) == 8);
+        CHECK(std::equal(added.begin(), added.end(), composition.children(parent0).begin()));
+        // Blocks of 4, 8 and 16 slots.
+        CHECK(composition.arenaSize() == 28);
+
+        parentSystem.erase(parent0);
+        CHECK(childSystem.size() == 2);
+        CHECK(composition.childrenSize(parent1) == 1);
+        // parent1 spills over, and the blocks of parent0 are reclaimed.
+        composition.addChild(parent1, childSystem.add());
+        composition.addChild(parent1, childSystem.add());
+        CHECK(composition.arenaSize() == 4);
+        CHECK(composition.childrenSize(parent1) == 3);
+    }
+    {
+        SystemWithDeletion<Test::Parent> parentSystem;
+        SystemWithDeletion<Test::Child> childSystem;
+        WeakAdapter<Test::Child> weakChildren(childSystem);
+        auto composition = makeComposition<SmallLeft<4>>(parentSystem, weakChildren);
+        auto parent = parentSystem.add();
+        auto child  = childSystem.add();
+        composition.addChild(parent, child);
+        CHECK(count(composition.children(parent), child) == 1);
+        parentSystem.erase(parent);
+        CHECK(childSystem.alive(child));
+    }
+}
+
+TEST_CASE("Bulk construction", "[Hierarchy]")
+{
+    auto test = [](auto&& parentSystem, auto&& childSystem, auto bulk, auto reference)
+    {
+        std::vector<Test::Parent> parents;
+        std::vector<Test::Child> children;
+        for(int i = 0; i < 4; ++i)
+        {
+            parents.push_back(parentSystem.add());
+        }
+        for(int i = 0; i < 40; ++i)
+        {
+            children.push_back(childSystem.add());
+        }
+        auto collect = [](auto& composition, Test::Parent parent)
+        {
+            std::vector<Test::Child> result;
+            for_each(composition.children(parent), [&](Test::Child child)
+            {
+                result.push_back(child);
+            });
+            return result;
+        };
+        // A few children already there, then a bulk for one parent and a whole relation.
+        std::vector<Test::Child> first(children.begin(), children.begin() + 3);
+        for(auto child : first)
+        {
+            reference.addChild(parents[1], child);
+        }
+        bulk.addChildren(parents[1], first);
+        std::vector<std::pair<Test::Parent, Test::Child>> pairs;
+        for(std::size_t i = 3; i < children.size(); ++i)
+        {
+            pairs.emplace_back(parents[(i * 7) % 3], children[i]);
+            reference.addChild(pairs.back().first, pairs.back().second);
+        }
+        bulk.buildFrom(pairs);
+        for(auto parent : parents)
+        {
+            CHECK(bulk.childrenSize(parent) == reference.childrenSize(parent));
+            CHECK(collect(bulk, parent) == collect(reference, parent));
+        }
+        return collect(bulk, parents[1]);
+    };
+    {
+        SystemWithDeletion<Test::Parent> parentSystem;
+        SystemWithDeletion<Test::Child> childSystem;
+        WeakAdapter<Test::Child> weakChildren(childSystem);
+        auto children = test(parentSystem, childSystem, makeComposition<Left>(parentSystem, weakChildren), makeComposition<Left>(parentSystem, weakChildren));
+        CHECK(children.size() == 15);
+    }
+    {
+        SystemWithDeletion<Test::Parent> parentSystem;
+        SystemWithDeletion<Test::Child> childSystem;
+        WeakAdapter<Test::Child> weakChildren(childSystem);
+        test(parentSystem, childSystem, makeComposition<Both>(parentSystem, weakChildren), makeComposition<Both>(parentSystem, weakChildren));
+    }
+    {
+        SystemWithDeletion<Test::Parent> parentSystem;
+        SystemWithDeletion<Test::Child> childSystem;
+        WeakAdapter<Test::Child> weakChildren(childSystem);
+        test(parentSystem, childSystem, makeComposition<SmallLeft<2>>(parentSystem, weakChildren), makeComposition<SmallLeft<2>>(parentSystem, weakChildren));
+    }
+}
+
+TEST_CASE("Bulk cascading erase", "[Hierarchy]")
+{
+    SystemWithDeletion<Test::Parent> modules;
+    SystemWithDeletion<Test::Parent> insts;
+    SystemWithDeletion<Test::Child> ports;
+    auto moduleInsts = makeComposition<Both>(modules, insts);
+    auto instPorts   = makeComposition<Both>(insts, ports);
+    auto portIds     = makeProperty<std::size_t>(ports);
+    std::size_t single = 0, bulk = 0;
+    ports.notifier->onErase.connect([&](Test::Child)
+    {
+        ++single;
+    });
+    ports.notifier->onEraseMany.connect([&](const std::vector<Test::Child>&)
+    {
+        ++bulk;
+    });
+    std::vector<Test::Parent> top{modules.add(), modules.add()};
+    std::vector<Test::Child> kept;
+    for(int i = 0; i < 10; ++i)
+    {
+        auto inst = insts.add();
+        moduleInsts.addChild(top[i % 2], inst);
+        for(int j = 0; j < 4; ++j)
+        {
+            auto port = ports.add();
+            portIds[port] = port.id();
+            instPorts.addChild(inst, port);
+            if(i % 2 == 1)
+            {
+                kept.push_back(port);
+            }
+        }
+    }
+    modules.erase(top[0]);
+    CHECK(single == 0);
+    CHECK(bulk == 1);
+    CHECK(insts.size() == 5);
+    CHECK(ports.size() == 20);
+    bool consistent = true;
+    for(auto port : kept)
+    {
+        consistent = consistent && ports.alive(port) && portIds[port] == port.id() && insts.alive(instPorts.parent(port));
+        consistent = consistent && moduleInsts.parent(instPorts.parent(port)) == top[1];
+    }
+    CHECK(consistent);
+    CHECK(moduleInsts.childrenSize(top[1]) == 5);
+}
+
+TEST_CASE("Bulk erase of some children", "[Hierarchy]")
+{
+    SystemWithDeletion<Test::Parent> parents;
+    SystemWithDeletion<Test::Child> children;
+    auto composition = makeComposition<Both>(parents, children);
+    auto parent = parents.add();
+    std::vector<Test::Child> child;
+    for(int i = 0; i < 8; ++i)
+    {
+        child.push_back(children.add());
+        composition.addChild(parent, child.back());
+    }
+    // The children left behind have to be relinked, and some of them are moved by the erase.
+    children.eraseMany(std::vector<Test::Child>{child[1], child[4], child[2]});
+    CHECK(composition.childrenSize(parent) == 5);
+    std::vector<std::size_t> ids;
+    ranges::for_each(composition.children(parent), [&](Test::Child en)
+    {
+        ids.push_back(en.id());
+    });
+    CHECK(ids == (std::vector<std::size_t>{7, 6, 5, 3, 0}));
+    bool consistent = true;
+    for(auto en : children.asRange())
+    {
+        consistent = consistent && composition.parent(en) == parent;
+        const Test::Child next = composition.nextSibling(en);
+        consistent = consistent && (next == Test::Child{} || composition.prevSibling(next) == en);
+    }
+    CHECK(consistent);
+}
+
+TEST_CASE("Cascading erase within one system", "[Hierarchy]")
+{
+    // The grandchild a1 is added before its parent A, so erasing the children of R moves the
+    // entities of the batch of R.
+    auto check = [](auto selector)
+    {
+        SystemWithDeletion<Test::Parent> nodes;
+        auto tree = makeComposition<decltype(selector)>(nodes, nodes);
+        auto ids  = makeProperty<std::size_t>(nodes);
+        std::vector<Test::Parent> node;
+        for(int i = 0; i < 7; ++i)
+        {
+            node.push_back(nodes.add());
+            ids[node.back()] = node.back().id();
+        }
+        const auto a1 = node[0], R = node[1], A = node[2], B = node[3], K = node[4], k = node[5], b1 = node[6];
+        tree.addChild(R, A);
+        tree.addChild(R, B);
+        tree.addChild(A, a1);
+        tree.addChild(K, k);
+        tree.addChild(B, b1);
+        nodes.erase(R);
+        CHECK(nodes.size() == 2);
+        CHECK(nodes.alive(K));
+        CHECK(nodes.alive(k));
+        CHECK(ids[K] == K.id());
+        CHECK(ids[k] == k.id());
+        CHECK(tree.firstChild(K) == k);
+        CHECK(tree.childrenSize(K) == 1);
+
+        for(int i = 0; i < 4; ++i)
+        {
+            node.push_back(nodes.add());
+            ids[node.back()] = node.back().id();
+        }
+        tree.addChild(node[8], node[9]);
+        tree.addChild(node[9], node[7]);
+        tree.addChild(node[8], node[10]);
+        nodes.eraseMany(std::vector<Test::Parent>{node[9], node[8]});
+        CHECK(nodes.size() == 2);
+        CHECK(ids[K] == K.id());
+        CHECK(ids[k] == k.id());
+    };
+    check(Both{});
+    check(Left{});
+    check(DoublyLinkedLeft{});
+}
+
+TEST_CASE("Traversal", "[Hierarchy]")
+{
+    SystemWithDeletion<Test::Parent> nodes;
+    auto tree = makeComposition<Left>(nodes, nodes);
+    //        0
+    //     1     2
+    //    3 4    5
+    //           6
+    std::vector<Test::Parent> node;
+    for(int i = 0; i < 7; ++i)
+    {
+        node.push_back(nodes.add());
+    }
+    tree.addChild(node[0], node[1]);
+    tree.addChild(node[0], node[2]);
+    tree.addChild(node[1], node[3]);
+    tree.addChild(node[1], node[4]);
+    tree.addChild(node[2], node[5]);
+    tree.addChild(node[5], node[6]);
+    auto ids = [](auto view)
+    {
+        std::vector<std::size_t> result;
+        ranges::for_each(view, [&](Test::Parent en)
+        {
+            result.push_back(en.id());
+        });
+        return result;
+    };
+    // Children are linked at the front, so siblings come in reverse order of addition.
+    std::vector<std::size_t> children;
+    ranges::for_each(tree.children(node[0]), [&](Test::Parent child)
+    {
+        children.push_back(child.id());
+    });
+    REQUIRE(children == (std::vector<std::size_t>{2, 1}));
+    TraversalBuffer<Test::Parent> buffer;
+    CHECK(ids(preorder(node[0], childrenOf(tree), buffer)) == (std::vector<std::size_t>{0, 2, 5, 6, 1, 4, 3}));
+    CHECK(ids(postorder(node[0], childrenOf(tree), buffer)) == (std::vector<std::size_t>{6, 5, 2, 4, 3, 1, 0}));
+    CHECK(ids(levelOrder(node[0], childrenOf(tree), buffer)) == (std::vector<std::size_t>{0, 2, 1, 5, 4, 3, 6}));
+    CHECK(ids(preorder(node[5], childrenOf(tree), buffer)) == (std::vector<std::size_t>{5, 6}));
+    CHECK(ids(postorder(node[4], childrenOf(tree), buffer)) == (std::vector<std::size_t>{4}));
+    const std::size_t capacity = buffer.capacity();
+    ids(preorder(node[0], childrenOf(tree), buffer));
+    CHECK(buffer.capacity() == capacity);
+}
+
+TEST_CASE("Level order buffer", "[Hierarchy]")
+{
+    // Eight chains of 200 nodes below the root: the frontier never holds more than eight nodes.
+    SystemWithDeletion<Test::Parent> nodes;
+    auto tree = makeComposition<Left>(nodes, nodes);
+    const auto root = nodes.add();
+    for(int chain = 0; chain < 8; ++chain)
+    {
+        auto parent = root;
+        for(int i = 0; i < 200; ++i)
+        {
+            const auto child = nodes.add();
+            tree.addChild(parent, child);
+            parent = child;
+        }
+    }
+    TraversalBuffer<Test::Parent> buffer;
+    std::size_t visited = 0;
+    ranges::for_each(levelOrder(root, childrenOf(tree), buffer), [&](Test::Parent)
+    {
+        ++visited;
+    });
+    CHECK(visited == nodes.size());
+    CHECK(buffer.capacity() <= 64);
+}
+
+TEST_CASE("Parallel traversal", "[Hierarchy]")
+{
+    SystemWithDeletion<Test::Parent> nodes;
+    auto tree = makeComposition<Left>(nodes, nodes);
+    auto depth = makeProperty<std::size_t>(nodes);
+    auto visits = makeProperty<std::size_t>(nodes);
+    std::vector<Test::Parent> node{nodes.add()};
+    for(std::size_t i = 1; i < 1000; ++i)
+    {
+        node.push_back(nodes.add());
+        tree.addChild(node[(i - 1) / 3], node[i]);
+        depth[node[i]] = depth[node[(i - 1) / 3]] + 1;
+    }
+    tree.freeze();
+    ThreadPool pool(4);
+    std::vector<std::size_t> depthErrors(node.size(), 0);
+    parallelTraverse(pool, node[0], childrenOf(tree), [&](Test::Parent en)
+    {
+        ++visits[en];
+        if(en != node[0] && depth[en] != depth[Test::Parent{(en.id() - 1) / 3}] + 1)
+        {
+            ++depthErrors[en.id()];
+        }
+    });
+    CHECK(std::all_of(visits.asRange().begin(), visits.asRange().end(), [](std::size_t count){ return count == 1; }));
+    CHECK(std::count(depthErrors.begin(), depthErrors.end(), 0u) == static_cast<std::ptrdiff_t>(node.size()));
+}
+
+TEST_CASE("Euler tour index", "[Hierarchy]")
+{
+    SystemWithDeletion<Test::Parent> nodes;
+    auto tree = makeComposition<Both>(nodes, nodes);
+    auto index = makeEulerTourIndex(tree, nodes);
+    //        0         7
+    //     1     2
+    //    3 4    5
+    //           6
+    std::vector<Test::Parent> node;
+    for(int i = 0; i < 8; ++i)
+    {
+        node.push_back(nodes.add());
+    }
+    tree.addChild(node[0], node[2]);
+    tree.addChild(node[0], node[1]);
+    tree.addChild(node[1], node[4]);
+    tree.addChild(node[1], node[3]);
+    tree.addChild(node[2], node[5]);
+    tree.addChild(node[5], node[6]);
+    CHECK(index.stale());
+    CHECK(index.contains(node[0], node[6]));
+    CHECK(index.contains(node[2], node[2]));
+    CHECK(!index.isAncestor(node[2], node[2]));
+    CHECK(index.isAncestor(node[1], node[4]));
+    CHECK(!index.isAncestor(node[1], node[5]));
+    CHECK(!index.isAncestor(node[6], node[0]));
+    CHECK(!index.isAncestor(node[7], node[3]));
+    CHECK(!index.stale());
+    std::vector<std::size_t> ids;
+    ranges::for_each(index.subtree(node[0]), [&](Test::Parent en)
+    {
+        ids.push_back(en.id());
+    });
+    CHECK(ids == (std::vector<std::size_t>{0, 1, 3, 4, 2, 5, 6}));
+    CHECK(index.exit(node[2]) - index.entry(node[2]) == 3);
+    CHECK(index.order().size() == 8);
+
+    // A structural change, or a new node, makes the next query rebuild the labels.
+    tree.removeChild(node[0], node[2]);
+    tree.addChild(node[3], node[2]);
+    CHECK(index.stale());
+    CHECK(index.isAncestor(node[1], node[6]));
+    CHECK(index.isAncestor(node[3], node[5]));
+    node.push_back(nodes.add());
+    tree.addChild(node[7], node[8]);
+    CHECK(index.isAncestor(node[7], node[8]));
+    CHECK(!index.isAncestor(node[0], node[8]));
+    // The composition is strong, so the whole subtree of node 1 goes with it.
+    nodes.erase(node[1]);
+    CHECK(index.stale());
+    CHECK(index.order().size() == 3);
+    CHECK(index.subtree(node[7]).size() == 2);
+    CHECK(!index.isAncestor(node[0], node[7]));
+}
+
+TEST_CASE("Relation", "[Hierarchy]")
+{
+    SystemWithDeletion<Test::Parent> nets;
+    SystemWithDeletion<Test::Child> pins;
+    auto relation = makeRelation<TestEdge>(nets, pins);
+    auto weight = makeProperty<int>(relation.edges());
+    std::vector<Test::Parent> net{nets.add(), nets.add(), nets.add()};
+    std::vector<Test::Child> pin{pins.add(), pins.add(), pins.add(), pins.add()};
+    auto ids = [](auto view)
+    {
+        std::vector<std::size_t> result;
+        ranges::for_each(view, [&](TestEdge edge)
+        {
+            result.push_back(edge.id());
+        });
+        return result;
+    };
+    // A pin may be on several nets, and a net has several pins.
+    auto e0 = relation.connect(net[0], pin[0]);
+    auto e1 = relation.connect(net[0], pin[1]);
+    auto e2 = relation.connect(net[1], pin[1]);
+    relation.connect(std::vector<std::pair<Test::Parent, Test::Child>>{{net[1], pin[2]}, {net[2], pin[1]}, {net[2], pin[3]}});
+    weight[e1] = 7;
+    CHECK(relation.size() == 6);
+    CHECK(relation.from(e2) == net[1]);
+    CHECK(relation.to(e2) == pin[1]);
+    CHECK(relation.degreeFrom(net[0]) == 2);
+    CHECK(relation.degreeTo(pin[1]) == 3);
+    CHECK(ids(relation.edgesFrom(net[0])) == (std::vector<std::size_t>{1, 0}));
+    CHECK(ids(relation.edgesTo(pin[1])) == (std::vector<std::size_t>{4, 2, 1}));
+
+    relation.disconnect(e2);
+    CHECK(ids(relation.edgesTo(pin[1])) == (std::vector<std::size_t>{4, 1}));
+    CHECK(ids(relation.edgesFrom(net[1])) == (std::vector<std::size_t>{3}));
+
+    // Erasing an endpoint erases its edges, and their properties go with them.
+    pins.erase(pin[1]);
+    CHECK(relation.size() == 3);
+    CHECK(ids(relation.edgesFrom(net[0])) == (std::vector<std::size_t>{0}));
+    CHECK(ids(relation.edgesFrom(net[2])) == (std::vector<std::size_t>{5}));
+    CHECK(weight.size() == 3);
+    nets.eraseMany(std::vector<Test::Parent>{net[0], net[2]});
+    CHECK(relation.size() == 1);
+    CHECK(relation.degreeTo(pin[0]) == 0);
+    CHECK(ids(relation.edgesTo(pin[2])) == (std::vector<std::size_t>{3}));
+    CHECK(!relation.edges().alive(e0));
+
+    SystemWithDeletion<Test::Parent> netsCopy(nets);
+    SystemWithDeletion<Test::Child> pinsCopy(pins);
+    decltype(relation) copy(relation, netsCopy, pinsCopy);
+    copy.connect(net[1], pin[0]);
+    CHECK(copy.size() == 2);
+    CHECK(relation.size() == 1);
+    CHECK(copy.degreeFrom(net[1]) == 2);
+    CHECK(relation.degreeFrom(net[1]) == 1);
+}
+
+TEST_CASE("Cluster children", "[Hierarchy]")
+{
+    SystemWithDeletion<Test::Parent> parents;
+    SystemWithDeletion<Test::Child> children;
+    auto composition = makeComposition<Both>(parents, children);
+    auto ids = makeProperty<std::size_t>(children);
+    std::vector<Test::Parent> parent{parents.add(), parents.add(), parents.add()};
+    std::vector<Test::Child> child;
+    for(std::size_t i = 0; i < 10; ++i)
+    {
+        child.push_back(children.add());
+        ids[child.back()] = i;
+        if(i % 4 != 3)
+        {
+            composition.addChild(parent[i % 4], child.back());
+        }
+    }
+    composition.clusterChildren();
+    std::vector<std::size_t> order;
+    ranges::for_each(children.asRange(), [&](Test::Child en)
+    {
+        order.push_back(en.id());
+    });
+    // Each parent's children are linked at the front, so they come last added first.
+    CHECK(order == (std::vector<std::size_t>{8, 4, 0, 9, 5, 1, 6, 2, 3, 7}));
+    CHECK(std::equal(order.begin(), order.end(), ids.asRange().begin()));
+    CHECK(composition.childrenSize(parent[1]) == 3);
+    CHECK(composition.parent(child[9]) == parent[1]);
+    children.erase(child[5]);
+    std::vector<std::size_t> second;
+    ranges::for_each(composition.children(parent[1]), [&](Test::Child en)
+    {
+        second.push_back(ids[en]);
+    });
+    CHECK(second == (std::vector<std::size_t>{9, 1}));
+}
@@ -0,0 +1,113 @@
+#include <catch.hpp>
+#include <Entity/Core/PropertyIndex.hpp>
+#include <Entity/Core/SystemWithDeletion.hpp>
+#include "test.hpp"
+
+using namespace Entity;
+
+TEST_CASE("Index existing values", "[PropertyIndex]")
+{
+    SystemWithDeletion<Test::TestEntity> sys;
+    auto life = makeProperty<int>(sys);
+    auto en0 = sys.add();
+    auto en1 = sys.add();
+    auto en2 = sys.add();
+    life[en0] = 1;
+    life[en1] = 0;
+    life[en2] = 1;
+    auto index = makeIndex<Hashed>(sys, life);
+    CHECK(index.size() == 2);
+    CHECK(index.count(1) == 2);
+    CHECK(index.count(0) == 1);
+    CHECK(index.count(42) == 0);
+    CHECK(ranges::count(index.find(0), en1) == 1);
+    CHECK(ranges::count(index.find(1), en0) == 1);
+    CHECK(ranges::count(index.find(1), en2) == 1);
+}
+
+TEST_CASE("Index tracked writes", "[PropertyIndex]")
+{
+    SystemWithDeletion<Test::TestEntity> sys;
+    auto life = makeProperty<int>(sys);
+    auto index = makeIndex<Ordered>(sys, life);
+    auto en0 = sys.add();
+    auto en1 = sys.add();
+    CHECK(index.count(0) == 2);
+    index[en0] = 5;
+    index.set(en1, 7);
+    CHECK(life[en0] == 5);
+    CHECK(static_cast<const int&>(index[en1]) == 7);
+    CHECK(index.count(0) == 0);
+    CHECK(index.count(5) == 1);
+    CHECK(index.count(7) == 1);
+    index[en1] = 5;
+    CHECK(index.count(5) == 2);
+    CHECK(index.count(7) == 0);
+    CHECK(index.size() == 1);
+}
+
+TEST_CASE("Index add & erase", "[PropertyIndex]")
+{
+    SystemWithDeletion<Test::TestEntity> sys;
+    auto life = makeProperty<int>(sys);
+    auto index = makeIndex<Hashed>(sys, life);
+    std::vector<Test::TestEntity> entities;
+    for(int i = 0; i < 10; ++i)
+    {
+        entities.push_back(sys.add());
+        index[entities.back()] = i % 3;
+    }
+    sys.erase(entities[0]);
+    sys.erase(entities[4]);
+    CHECK(index.count(0) == 3);
+    CHECK(index.count(1) == 2);
+    CHECK(index.count(2) == 3);
+    CHECK(ranges::count(index.find(0), entities[0]) == 0);
+    CHECK(ranges::count(index.find(1), entities[4]) == 0);
+    for(auto en : sys.asRange())
+    {
+        CHECK(ranges::count(index.find(life[en]), en) == 1);
+    }
+}
+
+TEST_CASE("Index bulk erase", "[PropertyIndex]")
+{
+    SystemWithDeletion<Test::TestEntity> sys;
+    auto life = makeProperty<int>(sys);
+    auto index = makeIndex<Hashed>(sys, life);
+    std::vector<Test::TestEntity> entities;
+    for(int i = 0; i < 10; ++i)
+    {
+        entities.push_back(sys.add());
+        index[entities.back()] = i % 2;
+    }
+    sys.eraseMany(std::vector<Test::TestEntity>{entities[1], entities[2], entities[5]});
+    CHECK(index.count(0) == 4);
+    CHECK(index.count(1) == 3);
+    // The positions kept by the index must still be right for the entities moved by the erase.
+    sys.eraseMany(std::vector<Test::TestEntity>{entities[8], entities[9], entities[0]});
+    CHECK(index.count(0) == 2);
+    CHECK(index.count(1) == 2);
+    for(auto en : sys.asRange())
+    {
+        CHECK(ranges::count(index.find(life[en]), en) == 1);
+    }
+}
+
+TEST_CASE("Index range query", "[PropertyIndex]")
+{
+    SystemWithDeletion<Test::TestEntity> sys;
+    auto price = makeProperty<int>(sys);
+    auto index = makeIndex<Ordered>(sys, price);
+    std::vector<Test::TestEntity> entities;
+    for(int i = 0; i < 10; ++i)
+    {
+        entities.push_back(sys.add());
+        index[entities.back()] = i * 10;
+    }
+    auto cheap = index.range(20, 50);
+    CHECK(ranges::distance(cheap) == 3);
+    CHECK(ranges::count(cheap, entities[2]) == 1);
+    CHECK(ranges::count(cheap, entities[4]) == 1);
+    CHECK(ranges::count(cheap, entities[5]) == 0);
+}
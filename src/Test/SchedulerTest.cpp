@@ -0,0 +1,135 @@
+#include <catch.hpp>
+#include <numeric>
+#include <Entity/Core/Scheduler.hpp>
+#include <Entity/Core/Property.hpp>
+#include <Entity/Core/SystemWithDeletion.hpp>
+#include "test.hpp"
+
+using namespace Entity;
+
+TEST_CASE("Parallel for", "[Scheduler]")
+{
+    ThreadPool pool(4);
+    std::vector<int> values(10000, 1);
+    pool.parallelFor(0, values.size(), 128, [&](std::size_t begin, std::size_t end)
+    {
+        for(std::size_t i = begin; i < end; ++i)
+        {
+            values[i] += static_cast<int>(i);
+        }
+    });
+    std::vector<int> golden(values.size());
+    std::iota(golden.begin(), golden.end(), 1);
+    CHECK(values == golden);
+}
+
+TEST_CASE("Parallel for without workers", "[Scheduler]")
+{
+    ThreadPool pool(0);
+    std::atomic<std::size_t> sum{0};
+    pool.parallelFor(0, 1000, 10, [&](std::size_t begin, std::size_t end)
+    {
+        sum += end - begin;
+    });
+    CHECK(sum == 1000);
+}
+
+TEST_CASE("Parallel for propagates exceptions", "[Scheduler]")
+{
+    ThreadPool pool(2);
+    CHECK_THROWS_AS(pool.parallelFor(0, 100, 1, [](std::size_t begin, std::size_t)
+    {
+        if(begin == 42)
+        {
+            throw std::runtime_error("42");
+        }
+    }), std::runtime_error);
+}
+
+TEST_CASE("Dependencies", "[Scheduler]")
+{
+    SystemWithDeletion<Test::TestEntity> sys;
+    auto first  = makeProperty<int>(sys);
+    auto second = makeProperty<int>(sys);
+    auto sum    = makeProperty<int>(sys);
+    for(int i = 0; i < 1000; ++i)
+    {
+        sys.add();
+    }
+
+    Scheduler scheduler(4);
+    scheduler.addJob([&]()
+    {
+        ranges::fill(first.asRange(), 1);
+    }).writes(first);
+    scheduler.addJob([&]()
+    {
+        ranges::fill(second.asRange(), 2);
+    }).writes(second);
+    scheduler.addJob([&]()
+    {
+        scheduler.parallelFor(0, sys.size(), 64, [&](std::size_t begin, std::size_t end)
+        {
+            for(std::size_t i = begin; i < end; ++i)
+            {
+                sum.asRange().begin()[i] = first.asRange().begin()[i] + second.asRange().begin()[i];
+            }
+        });
+    }).reads(first).reads(second).writes(sum);
+    scheduler.addJob([&]()
+    {
+        ranges::fill(first.asRange(), 0);
+    }).writes(first);
+
+    for(int frame = 0; frame < 10; ++frame)
+    {
+        scheduler.run();
+        CHECK(std::all_of(sum.asRange().begin(), sum.asRange().end(), [](int value){ return value == 3; }));
+        CHECK(std::all_of(first.asRange().begin(), first.asRange().end(), [](int value){ return value == 0; }));
+    }
+}
+
+TEST_CASE("Exclusive jobs", "[Scheduler]")
+{
+    SystemWithDeletion<Test::TestEntity> sys;
+    auto life = makeProperty<int>(sys);
+    for(int i = 0; i < 100; ++i)
+    {
+        life[sys.add()] = i % 3;
+    }
+    Scheduler scheduler(2);
+    std::vector<Test::TestEntity> toKill;
+    scheduler.addJob([&]()
+    {
+        toKill = sys.asRange() | ranges::view::filter([&](Test::TestEntity en){ return life[en] == 0; });
+        for(auto en : toKill)
+        {
+            sys.erase(en);
+        }
+    }).exclusive();
+    scheduler.addJob([&]()
+    {
+        ranges::for_each(life.asRange(), [](int& value){ --value; });
+    }).writes(life);
+    scheduler.run();
+    CHECK(sys.size() == 66);
+    CHECK(life.size() == 66);
+    CHECK(ranges::count(life.asRange(), -1) == 0);
+}
+
+TEST_CASE("Job exceptions", "[Scheduler]")
+{
+    Scheduler scheduler(2);
+    int column = 0;
+    bool ran = false;
+    scheduler.addJob([&]()
+    {
+        throw std::runtime_error("failed");
+    }).writes(column);
+    scheduler.addJob([&]()
+    {
+        ran = true;
+    }).reads(column);
+    CHECK_THROWS_AS(scheduler.run(), std::runtime_error);
+    CHECK(!ran);
+}
@@ -0,0 +1,72 @@
+#include <catch.hpp>
+#include <Entity/Core/StaticSystem.hpp>
+#include "test.hpp"
+
+using namespace Entity;
+
+TEST_CASE("Static system empty", "[StaticSystem]")
+{
+    constexpr StaticSystem<Test::TestEntity, 4> constSystem;
+    static_assert(constSystem.capacity() == 4, "capacity is known at compile time");
+    static_assert(constSystem.empty(), "a constexpr system starts empty");
+    StaticSystem<Test::TestEntity, 4> system;
+    CHECK(system.empty());
+    CHECK(system.size() == 0);
+    CHECK(!system.alive(Test::TestEntity{}));
+    CHECK(!system.alive(Test::TestEntity{0}));
+}
+
+TEST_CASE("Static system add & erase", "[StaticSystem]")
+{
+    StaticSystem<Test::TestEntity, 3> system;
+    auto en0 = system.add();
+    auto en1 = system.add();
+    auto en2 = system.add();
+    CHECK(system.size() == 3);
+    CHECK_THROWS_AS(system.add(), std::length_error);
+    system.erase(en1);
+    CHECK(system.size() == 2);
+    CHECK(system.alive(en0));
+    CHECK(!system.alive(en1));
+    CHECK(system.alive(en2));
+    CHECK(ranges::count(system.asRange(), en1) == 0);
+    CHECK_THROWS(system.erase(en1));
+    auto en3 = system.add();
+    CHECK(system.alive(en3));
+    CHECK(en3.id() < 3);
+    CHECK(system.size() == 3);
+}
+
+TEST_CASE("Static property", "[StaticSystem]")
+{
+    StaticSystem<Test::TestEntity, 8> system;
+    auto en0 = system.add();
+    auto prop = makeProperty<double>(system);
+    CHECK(prop.size() == 1);
+    auto en1 = system.add();
+    auto en2 = system.add();
+    prop[en0] = 1.0;
+    prop[en1] = 2.0;
+    prop[en2] = 3.0;
+    system.erase(en0);
+    CHECK(prop.size() == 2);
+    CHECK(prop[en1] == 2.0);
+    CHECK(prop[en2] == 3.0);
+    auto en3 = system.add();
+    CHECK(prop[en3] == 0.0);
+    CHECK(ranges::count(prop.asRange(), 1.0) == 0);
+}
+
+TEST_CASE("Static property scope", "[StaticSystem]")
+{
+    StaticSystem<Test::TestEntity, 8> system;
+    auto outer = makeProperty<int>(system);
+    {
+        auto inner = makeProperty<int>(system);
+        inner[system.add()] = 42;
+    }
+    auto en = system.add();
+    outer[en] = 7;
+    system.erase(en);
+    CHECK(system.size() == 1);
+}
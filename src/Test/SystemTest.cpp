@@ -1,5 +1,11 @@
 #include <catch.hpp>
+#include <atomic>
+#include <iterator>
+#include <sstream>
+#include <thread>
 #include <Entity/Core/System.hpp>
+#include <Entity/Core/ConcurrentKeyWrapper.hpp>
+#include <Entity/Core/PathKeyWrapper.hpp>
 #include "test.hpp"
 
 using namespace Entity;
@@ -112,6 +118,63 @@ TEST_CASE_METHOD(Test::Fixture::WithOneEntity<SystemWithDeletion>, "erase invali
     CHECK(!system.empty());
 }
 
+TEST_CASE_METHOD(Test::Fixture::Empty<SystemWithDeletion>, "eraseMany", "[System]")
+{
+    auto values = makeProperty<std::size_t>(system);
+    auto names  = makeKeyWrapper<std::string>(system);
+    std::vector<Test::TestEntity> entities;
+    for(std::size_t i = 0; i < 10; ++i)
+    {
+        entities.push_back(names.addOrGet(std::to_string(i)));
+        values[entities.back()] = i;
+    }
+    std::vector<std::vector<Test::TestEntity>> notified;
+    system.notifier->onEraseMany.connect([&](const std::vector<Test::TestEntity>& erased)
+    {
+        notified.push_back(erased);
+    });
+    system.erase(entities[5]);
+    system.eraseMany(std::vector<Test::TestEntity>{entities[1], entities[8], entities[5], entities[0], entities[8], entities[9]});
+    REQUIRE(notified.size() == 1);
+    // Dead and repeated entities are dropped, the others come from the last dense index to the first.
+    CHECK(notified.front() == (std::vector<Test::TestEntity>{entities[8], entities[9], entities[1], entities[0]}));
+    CHECK(system.size() == 5);
+    bool consistent = true;
+    for(std::size_t i : {2, 3, 4, 6, 7})
+    {
+        consistent = consistent && system.alive(entities[i]) && values[entities[i]] == i && names.at(std::to_string(i)) == entities[i];
+    }
+    CHECK(consistent);
+    CHECK(!names.has("8"));
+    system.eraseMany(std::vector<Test::TestEntity>{});
+    CHECK(notified.size() == 1);
+}
+
+TEST_CASE_METHOD(Test::Fixture::Empty<SystemWithDeletion>, "permute", "[System]")
+{
+    auto values = makeProperty<std::string>(system);
+    auto names  = makeKeyWrapper<std::string>(system);
+    std::vector<Test::TestEntity> entities;
+    for(std::size_t i = 0; i < 6; ++i)
+    {
+        entities.push_back(names.addOrGet(std::to_string(i)));
+        values[entities.back()] = "value" + std::to_string(i);
+    }
+    system.erase(entities[2]);
+    const std::vector<Test::TestEntity> order{entities[4], entities[0], entities[5], entities[3], entities[1]};
+    system.permute(order);
+    CHECK(std::vector<Test::TestEntity>(system.asRange().begin(), system.asRange().end()) == order);
+    CHECK(std::vector<std::string>(values.asRange().begin(), values.asRange().end()) == (std::vector<std::string>{"value4", "value0", "value5", "value3", "value1"}));
+    CHECK(names.at("5") == entities[5]);
+    CHECK(names.key(entities[1]) == "1");
+    system.erase(entities[0]);
+    CHECK(values[entities[1]] == "value1");
+    CHECK(values[entities[4]] == "value4");
+    CHECK_THROWS_AS(system.permute(std::vector<Test::TestEntity>{entities[4], entities[5], entities[3]}), std::invalid_argument);
+    CHECK_THROWS_AS(system.permute(std::vector<Test::TestEntity>{entities[4], entities[4], entities[5], entities[3]}), std::invalid_argument);
+    CHECK_THROWS_AS(system.permute(std::vector<Test::TestEntity>{entities[4], entities[0], entities[5], entities[3]}), std::invalid_argument);
+}
+
 TEST_CASE_METHOD(Test::Fixture::WithThreeEntities<SystemWithDeletion>, "connectOnErase", "[System]")
 {
     using ContainerType = std::vector<Test::TestEntity>;
@@ -183,3 +246,344 @@ TEST_CASE_METHOD(Test::Fixture::KeyWrapperWithEntity, "KeyWrapper erase", "[Syst
     CHECK(keyWrapper.has(key()));
     CHECK(entity != entity2);
 }
+
+TEST_CASE_METHOD(Test::Fixture::Empty<SystemWithDeletion>, "KeyWrapper forgets erased entities", "[System]")
+{
+    auto names   = makeKeyWrapper<std::string>(system);
+    auto numbers = makeKeyWrapper<int>(system);
+    auto first   = names.addOrGet("first");
+    auto second  = numbers.addOrGet(2);
+    auto third   = names.addOrGet("third");
+    auto moved   = std::move(names);
+    system.erase(first);
+    system.erase(second);
+    CHECK(!moved.has("first"));
+    CHECK(!numbers.has(2));
+    CHECK(moved.has("third"));
+    CHECK(moved.key(third) == "third");
+    REQUIRE_THROWS(moved.at("first"));
+    CHECK(moved.addOrGet("first") != first);
+    CHECK(system.size() == 2);
+}
+
+TEST_CASE_METHOD(Test::Fixture::Empty<SystemWithDeletion>, "KeyWrapper concurrent lookups", "[System]")
+{
+    auto keyWrapper = makeKeyWrapper<std::string>(system);
+    std::vector<Test::TestEntity> entities;
+    for(int i = 0; i < 1000; ++i)
+    {
+        entities.push_back(keyWrapper.addOrGet(std::to_string(i)));
+    }
+    for(int i = 0; i < 1000; i += 2)
+    {
+        system.erase(entities[i]);
+    }
+    std::atomic<int> found{0};
+    std::vector<std::thread> threads;
+    for(int thread = 0; thread < 4; ++thread)
+    {
+        threads.emplace_back([&]()
+        {
+            for(int i = 0; i < 1000; ++i)
+            {
+                found += keyWrapper.has(std::to_string(i));
+            }
+        });
+    }
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+    CHECK(found == 4 * 500);
+}
+
+TEST_CASE_METHOD(Test::Fixture::Empty<SystemWithDeletion>, "ConcurrentKeyWrapper", "[System]")
+{
+    ConcurrentKeyWrapper<Test::TestEntity, SystemWithDeletion> keyWrapper(system);
+    auto lengths = makeProperty<std::size_t>(system);
+    std::vector<std::vector<Test::TestEntity>> added(4, std::vector<Test::TestEntity>(1000));
+    std::vector<std::thread> threads;
+    for(int thread = 0; thread < 4; ++thread)
+    {
+        // Every thread adds the same 1000 keys, in a different order.
+        threads.emplace_back([&, thread]()
+        {
+            for(int i = 0; i < 1000; ++i)
+            {
+                const int key = (i * 7 + thread * 250) % 1000;
+                added[thread][key] = keyWrapper.addOrGet(std::to_string(key));
+            }
+        });
+    }
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+    CHECK(system.size() == 1000);
+    CHECK(lengths.size() == 1000);
+    for(int i = 0; i < 1000; ++i)
+    {
+        const auto en = keyWrapper.at(std::to_string(i));
+        CHECK(keyWrapper.key(en) == std::to_string(i));
+        CHECK(added[0][i] == en);
+        CHECK(added[1][i] == en);
+        CHECK(added[2][i] == en);
+        CHECK(added[3][i] == en);
+    }
+    const auto bytes = keyWrapper.key(keyWrapper.at("42")).data();
+    system.erase(keyWrapper.at("42"));
+    CHECK(!keyWrapper.has("42"));
+    CHECK(keyWrapper.has("43"));
+    REQUIRE_THROWS(keyWrapper.at("42"));
+    const auto again = keyWrapper.addOrGet("42");
+    CHECK(keyWrapper.at("42") == again);
+    CHECK(keyWrapper.key(again) == "42");
+    CHECK(keyWrapper.key(again).data() == bytes);
+
+    system.eraseMany(std::vector<Test::TestEntity>{keyWrapper.at("1"), keyWrapper.at("2"), again});
+    CHECK(!keyWrapper.has("1"));
+    CHECK(!keyWrapper.has("42"));
+    CHECK(keyWrapper.at("3") == added[0][3]);
+    CHECK(keyWrapper.key(keyWrapper.addOrGet("2")) == "2");
+}
+
+TEST_CASE_METHOD(Test::Fixture::Empty<SystemWithDeletion>, "KeyWrapper bulk load", "[System]")
+{
+    auto keyWrapper = makeKeyWrapper<std::string>(system);
+    auto existing = keyWrapper.addOrGet("7");
+    std::vector<std::string> keys;
+    for(int i = 0; i < 10000; ++i)
+    {
+        keys.push_back(std::to_string(i));
+    }
+    keyWrapper.bulkLoad(keys);
+    CHECK(keyWrapper.frozen());
+    CHECK(system.size() == 10000);
+    CHECK(keyWrapper.at("7") == existing);
+    bool allFound = true;
+    for(const auto& key : keys)
+    {
+        allFound = allFound && keyWrapper.key(keyWrapper.at(key)) == key;
+    }
+    CHECK(allFound);
+    CHECK(!keyWrapper.has("10000"));
+    CHECK(!keyWrapper.has(""));
+
+    system.erase(existing);
+    CHECK(keyWrapper.frozen());
+    CHECK(!keyWrapper.has("7"));
+    CHECK(keyWrapper.has("8"));
+
+    auto added = keyWrapper.addOrGet("7");
+    CHECK(!keyWrapper.frozen());
+    CHECK(keyWrapper.at("7") == added);
+    CHECK(keyWrapper.has("9999"));
+    CHECK(keyWrapper.freeze());
+    CHECK(keyWrapper.at("7") == added);
+
+    // A single-pass range is walked once.
+    std::istringstream stream("a b c a");
+    keyWrapper.bulkLoad(ranges::make_iterator_range(std::istream_iterator<std::string>(stream), std::istream_iterator<std::string>()));
+    CHECK(keyWrapper.frozen());
+    CHECK(system.size() == 10003);
+    CHECK(keyWrapper.key(keyWrapper.at("c")) == "c");
+}
+
+TEST_CASE_METHOD(Test::Fixture::Empty<SystemWithDeletion>, "KeyWrapper lookup batch", "[System]")
+{
+    auto keyWrapper = makeKeyWrapper<std::string>(system);
+    std::vector<std::string> keys;
+    for(int i = 0; i < 100; ++i)
+    {
+        keys.push_back(std::to_string(i));
+    }
+    keyWrapper.bulkLoad(std::vector<std::string>(keys.begin(), keys.begin() + 50));
+    std::vector<Test::TestEntity> batch;
+    for(int frozen = 1; frozen >= 0; --frozen)
+    {
+        CHECK(keyWrapper.frozen() == static_cast<bool>(frozen));
+        batch.clear();
+        keyWrapper.lookupBatch(keys, std::back_inserter(batch));
+        REQUIRE(batch.size() == keys.size());
+        bool allFound = true;
+        for(std::size_t i = 0; i < keys.size(); ++i)
+        {
+            allFound = allFound && batch[i] == (i < 50 ? keyWrapper.at(keys[i]) : Test::TestEntity{});
+        }
+        CHECK(allFound);
+        keyWrapper.addOrGet("new");
+    }
+}
+
+TEST_CASE("PathTree", "[System]")
+{
+    PathTree tree;
+    auto n0 = tree.addOrGet("top.u1.n0");
+    auto u1 = tree.find("top.u1");
+    CHECK(tree.size() == 4);
+    CHECK(tree.parent(n0) == u1);
+    CHECK(tree.segment(n0) == "n0");
+    CHECK(tree.path(n0) == "top.u1.n0");
+    CHECK(tree.path(PathTree::root()) == "");
+    CHECK(tree.addOrGetChild(u1, "n0") == n0);
+    CHECK(tree.find("n0", u1) == n0);
+    CHECK(tree.find("top.u2") == PathTree::npos());
+    CHECK(tree.child(PathTree::root(), "u1") == PathTree::npos());
+    auto n1 = tree.addOrGet("top.u2.n0");
+    CHECK(n1 != n0);
+    CHECK(tree.path(n1) == "top.u2.n0");
+    CHECK(tree.bytes() == 9);
+}
+
+TEST_CASE_METHOD(Test::Fixture::Empty<SystemWithDeletion>, "PathKeyWrapper", "[System]")
+{
+    auto tree  = std::make_shared<PathTree>();
+    auto decls = makePathKeyWrapper(system, tree);
+    SystemWithDeletion<Test::TestEntity> wires;
+    auto wireNames = makePathKeyWrapper(wires, tree);
+
+    auto top  = decls.addOrGet("top");
+    auto wire = wireNames.addOrGet(decls.node(top), "n0");
+    CHECK(wireNames.key(wire) == "top.n0");
+    CHECK(wireNames.segment(wire) == "n0");
+    CHECK(wireNames.at("top.n0") == wire);
+    CHECK(wireNames.at(decls.node(top), "n0") == wire);
+    CHECK(wireNames.addOrGet("top.n0") == wire);
+    CHECK(!wireNames.has("top"));
+    CHECK(!decls.has("top.n0"));
+    REQUIRE_THROWS(decls.at("top.n0"));
+
+    wires.erase(wire);
+    CHECK(!wireNames.has("top.n0"));
+    auto other = wireNames.addOrGet("top.n0");
+    CHECK(other != wire);
+    CHECK(wireNames.key(other) == "top.n0");
+    CHECK(tree->size() == 3);
+
+    std::vector<Test::TestEntity> batch;
+    std::vector<std::string> segments{"n0", "n1", "top"};
+    wireNames.addOrGet("n1");
+    wireNames.lookupBatch(decls.node(top), segments, std::back_inserter(batch));
+    CHECK(batch == (std::vector<Test::TestEntity>{other, Test::TestEntity{}, Test::TestEntity{}}));
+
+    auto n1 = wireNames.at("n1");
+    wires.eraseMany(std::vector<Test::TestEntity>{other, n1});
+    CHECK(!wireNames.has("top.n0"));
+    CHECK(!wireNames.has("n1"));
+    CHECK(wireNames.addOrGet("n1") != n1);
+}
+
+TEST_CASE("StringPool", "[System]")
+{
+    StringPool pool(8);
+    auto first  = pool.append("abcd");
+    auto second = pool.append("efg");
+    auto third  = pool.append("a string longer than a block");
+    auto fourth = pool.append("hij");
+    CHECK(first == "abcd");
+    CHECK(second == "efg");
+    CHECK(second.data() == first.data() + 4);
+    CHECK(third == "a string longer than a block");
+    CHECK(fourth == "hij");
+    CHECK(pool.append("").empty());
+    CHECK(pool.bytes() == 38);
+    CHECK(pool.capacity() == 8 + 28 + 8);
+}
+
+TEST_CASE_METHOD(Test::Fixture::KeyWrapperWithEntity, "KeyWrapper interns keys", "[System]")
+{
+    const std::size_t bytes = keyWrapper.pool().bytes();
+    CHECK(bytes == key().size());
+    auto other = keyWrapper.addOrGet("other");
+    CHECK(keyWrapper.pool().bytes() == bytes + 5);
+    CHECK(keyWrapper.key(other) == "other");
+    CHECK(keyWrapper.addOrGet(std::string("other")) == other);
+    CHECK(keyWrapper.pool().bytes() == bytes + 5);
+    system.erase(entity);
+    auto entity2 = keyWrapper.addOrGet(key());
+    CHECK(keyWrapper.key(entity2) == key());
+    CHECK(keyWrapper.key(other) == "other");
+    for(int i = 0; i < 3; ++i)
+    {
+        system.erase(keyWrapper.at("other"));
+        keyWrapper.addOrGet("other");
+    }
+    CHECK(keyWrapper.pool().bytes() == bytes + 5);
+
+    const std::vector<std::string> keys{"a", "b", "c", "d"};
+    for(const auto& theKey : keys)
+    {
+        keyWrapper.addOrGet(theKey);
+    }
+    const std::size_t loaded = keyWrapper.pool().bytes();
+    system.eraseMany(std::vector<Test::TestEntity>{keyWrapper.at("a"), keyWrapper.at("b"), keyWrapper.at("c")});
+    system.erase(keyWrapper.at("d"));
+    CHECK(!keyWrapper.has("a"));
+    CHECK(!keyWrapper.has("d"));
+    REQUIRE_THROWS(keyWrapper.at("b"));
+    for(const auto& theKey : {"b", "d", "a", "c"})
+    {
+        CHECK(keyWrapper.key(keyWrapper.addOrGet(theKey)) == theKey);
+    }
+    CHECK(keyWrapper.pool().bytes() == loaded);
+    for(const auto& theKey : keys)
+    {
+        CHECK(keyWrapper.key(keyWrapper.at(theKey)) == theKey);
+    }
+}
+
+TEST_CASE("KeyTable", "[System]")
+{
+    KeyTable table;
+    auto equalTo = [](std::size_t id)
+    {
+        return [id](std::size_t other){ return other == id; };
+    };
+    // Every entry has the same home slot, so they form a single probe run.
+    for(std::size_t id = 0; id < 5; ++id)
+    {
+        table.insert(8, id);
+    }
+    table.insert(9, 5);
+    CHECK(table.size() == 6);
+    CHECK(table.find(8, equalTo(3)) == 3);
+    CHECK(table.find(9, equalTo(5)) == 5);
+    CHECK(table.find(8, equalTo(5)) == KeyTable::npos());
+    CHECK(table.erase(8, equalTo(1)));
+    CHECK(!table.erase(8, equalTo(1)));
+    CHECK(table.size() == 5);
+    for(std::size_t id : {0, 2, 3, 4})
+    {
+        CHECK(table.find(8, equalTo(id)) == id);
+    }
+    CHECK(table.find(9, equalTo(5)) == 5);
+    CHECK(!table.full());
+    table.rehash([](std::size_t id){ return id != 0; });
+    CHECK(table.size() == 4);
+    CHECK(table.capacity() == 8);
+    CHECK(table.find(8, equalTo(0)) == KeyTable::npos());
+    CHECK(table.find(9, equalTo(5)) == 5);
+    for(std::size_t id = 6; id < 100; ++id)
+    {
+        if(table.full())
+        {
+            table.rehash([](std::size_t){ return true; });
+        }
+        table.insert(id * 7919, id);
+    }
+    CHECK(table.size() == 98);
+    CHECK(table.capacity() == 128);
+    CHECK(table.find(50 * 7919, equalTo(50)) == 50);
+
+    table.reserve(500);
+    CHECK(table.capacity() == 1024);
+    CHECK(table.find(50 * 7919, equalTo(50)) == 50);
+    for(std::size_t id = 100; id < 500; ++id)
+    {
+        CHECK(!table.full());
+        table.insert(id * 7919, id);
+    }
+    CHECK(table.capacity() == 1024);
+    table.reserve(10);
+    CHECK(table.capacity() == 1024);
+}
@@ -1,6 +1,7 @@
 #include <iostream>
 
 #include <Entity/Core/TupleVector.hpp>
+#include <Entity/Core/ChunkedTupleVector.hpp>
 
 template <uint32_t N, class Callable>
 void repeat(Callable cb)
@@ -22,6 +23,17 @@ void tupleVector()
     std::cout << "capacity = " << vec.capacity() << " size = " << vec.size() << std::endl;
 }
 
+void chunkedTupleVector()
+{
+    using namespace Entity;
+    ChunkedTupleVector<1024, uint32_t, uint8_t, uint64_t> vec;
+    repeat<10000000>([&]()
+    {
+       vec.resize(vec.size() + 1);
+    });
+    std::cout << "capacity = " << vec.capacity() << " size = " << vec.size() << std::endl;
+}
+
 void baseline()
 {
     std::vector<uint32_t> vec0;
@@ -52,6 +64,7 @@ int main(int, char*[])
 {
     profile("Baseline", baseline);
     profile("Tuple Vector", tupleVector);
+    profile("Chunked Tuple Vector", chunkedTupleVector);
     return 0;
 }
 
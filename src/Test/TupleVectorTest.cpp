@@ -1,5 +1,10 @@
 #include <catch.hpp>
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
 #include <Entity/Core/TupleVector.hpp>
+#include <Entity/Core/ChunkedTupleVector.hpp>
 
 using namespace Entity;
 
@@ -22,90 +27,114 @@ TEST_CASE("Empty tuple vector", "[TupleVector]")
     }
 }
 
-TEST_CASE("Words needed", "[TupleVector]")
+TEST_CASE("Bytes needed", "[TupleVector]")
 {
-    auto wordsNeededZero = [](std::size_t i)
+    auto bytesNeededZero = [](std::size_t i)
     {
-      return TupleVectorTraits<0, uint8_t>::wordsNeeded(i);
+      return TupleVectorTraits<0, uint8_t>::bytesNeeded(i);
     };
 
-    auto wordsNeededOne1Byte = [](std::size_t i)
+    auto bytesNeededOne1Byte = [](std::size_t i)
     {
-      return TupleVectorTraits<1, uint8_t>::wordsNeeded(i);
+      return TupleVectorTraits<1, uint8_t>::bytesNeeded(i);
     };
 
-    auto wordsNeededOne4Bytes = [](std::size_t i)
+    auto bytesNeededOne4Bytes = [](std::size_t i)
     {
-      return TupleVectorTraits<1, uint32_t>::wordsNeeded(i);
+      return TupleVectorTraits<1, uint32_t>::bytesNeeded(i);
     };
 
-    auto wordsNeededTwo = [](std::size_t i)
+    auto bytesNeededTwo = [](std::size_t i)
     {
-      return TupleVectorTraits<2, uint8_t, uint32_t>::wordsNeeded(i);
+      return TupleVectorTraits<2, uint8_t, uint32_t>::bytesNeeded(i);
     };
 
-    CHECK(wordsNeededZero(0) == 0);
-    CHECK(wordsNeededOne1Byte(0) == 0);
-    CHECK(wordsNeededOne1Byte(1) == 1);
-    CHECK(wordsNeededOne1Byte(2) == 1);
-    CHECK(wordsNeededOne1Byte(3) == 1);
-    CHECK(wordsNeededOne1Byte(4) == 1);
-    CHECK(wordsNeededOne1Byte(5) == 2);
-    CHECK(wordsNeededOne1Byte(6) == 2);
-    CHECK(wordsNeededOne1Byte(7) == 2);
-    CHECK(wordsNeededOne1Byte(8) == 2);
-    CHECK(wordsNeededOne1Byte(9) == 3);
-    CHECK(wordsNeededOne4Bytes(1) == 1);
-    CHECK(wordsNeededOne4Bytes(2) == 2);
-    CHECK(wordsNeededOne4Bytes(3) == 3);
-    CHECK(wordsNeededTwo(0) == 0);
-    CHECK(wordsNeededTwo(1) == 2);
-    CHECK(wordsNeededTwo(2) == 1 + 2);
-    CHECK(wordsNeededTwo(3) == 1 + 3);
-    CHECK(wordsNeededTwo(4) == 1 + 4);
-    CHECK(wordsNeededTwo(5) == 2 + 5);
+    CHECK(bytesNeededZero(0) == 0);
+    CHECK(bytesNeededOne1Byte(0) == 0);
+    CHECK(bytesNeededOne1Byte(1) == 1);
+    CHECK(bytesNeededOne1Byte(5) == 5);
+    CHECK(bytesNeededOne4Bytes(1) == 4);
+    CHECK(bytesNeededOne4Bytes(3) == 12);
+    CHECK(bytesNeededTwo(0) == 0);
+    CHECK(bytesNeededTwo(1) == 4 + 4);
+    CHECK(bytesNeededTwo(2) == 4 + 8);
+    CHECK(bytesNeededTwo(4) == 4 + 16);
+    CHECK(bytesNeededTwo(5) == 8 + 20);
 }
 
 template<uint32_t offset>
-auto firstWord(std::size_t capacity)
+auto firstByte(std::size_t capacity)
 {
-    return TupleVectorTraits<offset, uint32_t, uint8_t, uint64_t>::firstWord(capacity);
+    return TupleVectorTraits<offset, uint32_t, uint8_t, uint64_t>::firstByte(capacity);
 }
 
 template<uint32_t offset>
-auto lastWord(std::size_t capacity)
+auto lastByte(std::size_t capacity)
 {
-    return TupleVectorTraits<offset, uint32_t, uint8_t, uint64_t>::lastWord(capacity);
+    return TupleVectorTraits<offset, uint32_t, uint8_t, uint64_t>::lastByte(capacity);
 }
 
-TEST_CASE("First word index", "[TupleVector]")
+TEST_CASE("First byte index", "[TupleVector]")
 {
-    CHECK(firstWord<1>(0)    == 0    + 0   + 0);
-    CHECK(firstWord<1>(42)   == 0    + 0   + 0);
-    CHECK(firstWord<1>(1024) == 0    + 0   + 0);
+    CHECK(firstByte<1>(0)    == 0);
+    CHECK(firstByte<1>(42)   == 0);
+    CHECK(firstByte<1>(1024) == 0);
 
-    CHECK(firstWord<2>(0)    == 0    + 0   + 0);
-    CHECK(firstWord<2>(42)   == 42   + 0   + 0);
-    CHECK(firstWord<2>(1024) == 1024 + 0   + 0);
+    CHECK(firstByte<2>(0)    == 0);
+    CHECK(firstByte<2>(42)   == 168);
+    CHECK(firstByte<2>(1024) == 4096);
 
-    CHECK(firstWord<3>(0)    == 0    + 0   + 0);
-    CHECK(firstWord<3>(42)   == 42   + 11  + 0);
-    CHECK(firstWord<3>(1024) == 1024 + 256 + 0);
+    // The 64 bits column is rounded up to a multiple of 8 bytes.
+    CHECK(firstByte<3>(0)    == 0);
+    CHECK(firstByte<3>(42)   == 168  + 42   + 6);
+    CHECK(firstByte<3>(1024) == 4096 + 1024 + 0);
 }
 
-TEST_CASE("Last word index", "[TupleVector]")
+TEST_CASE("Last byte index", "[TupleVector]")
 {
-    CHECK(lastWord<1>(0)    == 0    + 0   + 0   );
-    CHECK(lastWord<1>(42)   == 42   + 0   + 0   );
-    CHECK(lastWord<1>(1024) == 1024 + 0   + 0   );
+    CHECK(lastByte<1>(0)    == 0);
+    CHECK(lastByte<1>(42)   == 168);
+    CHECK(lastByte<1>(1024) == 4096);
 
-    CHECK(lastWord<2>(0)    == 0    + 0   + 0   );
-    CHECK(lastWord<2>(42)   == 42   + 11  + 0   );
-    CHECK(lastWord<2>(1024) == 1024 + 256 + 0   );
+    CHECK(lastByte<2>(0)    == 0);
+    CHECK(lastByte<2>(42)   == 168  + 42);
+    CHECK(lastByte<2>(1024) == 4096 + 1024);
 
-    CHECK(lastWord<3>(0)    == 0    + 0   + 0   );
-    CHECK(lastWord<3>(42)   == 42   + 11  + 84  );
-    CHECK(lastWord<3>(1024) == 1024 + 256 + 2048);
+    CHECK(lastByte<3>(0)    == 0);
+    CHECK(lastByte<3>(42)   == 216  + 336);
+    CHECK(lastByte<3>(1024) == 5120 + 8192);
+}
+
+TEST_CASE("Column alignment", "[TupleVector]")
+{
+    using Traits = TupleVectorTraits<3, uint8_t, Aligned<float, 64>, uint16_t>;
+    CHECK(Traits::alignment() == 64);
+    CHECK(Traits::Previous::firstByte(3) == 64);
+    CHECK(Traits::firstByte(3) == 64 + 12);
+    using PaddedTraits = TupleVectorTraits<2, uint8_t, Aligned<char, 2>>;
+    CHECK(PaddedTraits::firstByte(3) == 4);
+
+    TupleVector<uint8_t, uint64_t, Aligned<float, 64>> vector;
+    for(std::size_t size = 1; size < 100; size += 7)
+    {
+        vector.resize(size);
+        vector.set<0>(size - 1, static_cast<uint8_t>(size));
+        vector.set<1>(size - 1, size);
+        vector.set<2>(size - 1, size / 2.f);
+        const auto address = reinterpret_cast<std::uintptr_t>(vector.data());
+        CHECK(address % 64 == 0);
+    }
+    for(std::size_t size = 1; size < 100; size += 7)
+    {
+        CHECK(vector.at<0>(size - 1) == size);
+        CHECK(vector.at<1>(size - 1) == size);
+        CHECK(vector.at<2>(size - 1) == size / 2.f);
+    }
+    const auto copy = vector;
+    CHECK(copy.size() == vector.size());
+    CHECK(reinterpret_cast<std::uintptr_t>(copy.data()) % 64 == 0);
+    CHECK(copy.at<1>(99 - 1) == 99);
+    CHECK(copy.at<2>(99 - 1) == 99 / 2.f);
 }
 
 TEST_CASE("Access", "[TupleVector]")
@@ -187,39 +216,43 @@ TEST_CASE("Reserve & Resize", "[TupleVector]")
 
 TEST_CASE("Copy", "[TupleVector]")
 {
+    auto bytes = [](std::vector<uint32_t>& words)
+    {
+        return reinterpret_cast<unsigned char*>(words.data());
+    };
     {
         std::vector<uint32_t> origin{{1, 2}};
         std::vector<uint32_t> destination{{0, 0, 0}};
         CHECK(destination.size() == 3);
-        TupleVectorTraits<1, uint32_t>::copy(origin, 2, destination, 3);
+        TupleVectorTraits<1, uint32_t>::copy(bytes(origin), 2, bytes(destination), 3, 2);
         const std::vector<uint32_t> goldenResult{{1, 2, 0}};
         CHECK(destination == goldenResult);
     }
     {
         std::vector<uint32_t> origin{{1, 2, 3, 4}};
         std::vector<uint32_t> destination{{0, 0, 0, 0, 0, 0}};
-        TupleVectorTraits<1, uint32_t, uint32_t>::copy(origin, 2, destination, 3);
+        TupleVectorTraits<1, uint32_t, uint32_t>::copy(bytes(origin), 2, bytes(destination), 3, 2);
         const std::vector<uint32_t> goldenResult{{1, 2, 0, 0, 0, 0}};
         CHECK(destination == goldenResult);
     }
     {
         std::vector<uint32_t> origin{{1, 2, 3, 4}};
         std::vector<uint32_t> destination{{0, 0, 0, 0, 0, 0}};
-        TupleVectorTraits<2, uint32_t, uint32_t>::copy(origin, 2, destination, 3);
+        TupleVectorTraits<2, uint32_t, uint32_t>::copy(bytes(origin), 2, bytes(destination), 3, 2);
         const std::vector<uint32_t> goldenResult{{1, 2, 0, 3, 4, 0}};
         CHECK(destination == goldenResult);
     }
     {
         std::vector<uint32_t> origin{{1, 2, 3, 4}};
         std::vector<uint32_t> destination{{0, 0, 0, 0, 0, 0, 0, 0}};
-        TupleVectorTraits<1, uint32_t, uint32_t>::copy(origin, 2, destination, 4);
+        TupleVectorTraits<1, uint32_t, uint32_t>::copy(bytes(origin), 2, bytes(destination), 4, 2);
         const std::vector<uint32_t> goldenResult{{1, 2, 0, 0, 0, 0, 0, 0}};
         CHECK(destination == goldenResult);
     }
     {
         std::vector<uint32_t> origin{{0x00000001, 0x00000002, 0x00000403}};
         std::vector<uint32_t> destination{{0, 0, 0, 0, 0}};
-        TupleVectorTraits<2, uint32_t, uint8_t>::copy(origin, 2, destination, 4);
+        TupleVectorTraits<2, uint32_t, uint8_t>::copy(bytes(origin), 2, bytes(destination), 4, 2);
         const std::vector<uint32_t> goldenResult{{0x00000001, 0x00000002, 0, 0, 0x00000403}};
         CHECK(destination == goldenResult);
     }
@@ -228,8 +261,8 @@ TEST_CASE("Copy", "[TupleVector]")
 
 TEST_CASE("Reallocation keeps elements on their positions", "[TupleVector]")
 {
-    //[   0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25]
-    //[32_0,32_0,32_0,32_0,32_1,32_1,32_1,32_1, 8_0, 8_1,64_0,64_0,64_0,64_0,64_0,64_0,64_0,64_0,64_1,64_1,64_1,64_1,64_1,64_1,64_1,64_1]
+    //[   0,   1,   2,   3,   4,   5,   6,   7,   8,   9,  10,  11,  12,  13,  14,  15,  16,  17,  18,  19,  20,  21,  22,  23,  24,  25,  26,  27,  28,  29,  30,  31]
+    //[32_0,32_0,32_0,32_0,32_1,32_1,32_1,32_1, 8_0, 8_1,   -,   -,   -,   -,   -,   -,64_0,64_0,64_0,64_0,64_0,64_0,64_0,64_0,64_1,64_1,64_1,64_1,64_1,64_1,64_1,64_1]
     TupleVector<int32_t, int8_t, int64_t> vector(2);
 
     vector.set<0>(0, 0xCCCCCCFF);
@@ -279,3 +312,296 @@ TEST_CASE("Reallocation keeps elements on their positions", "[TupleVector]")
     CHECK(constVector.at<2>(2) == 0xDDDDDDDDEEEEEEEE);
 
 }
+
+TEST_CASE("New rows are zeroed", "[TupleVector]")
+{
+    TupleVector<int, double> vector;
+    vector.resize(3);
+    vector.set<0>(1, 7);
+    vector.set<1>(2, 1.5);
+    vector.resize(0);
+    vector.resize(100);
+    vector.emplace_back();
+    CHECK(std::all_of(vector.column<0>().begin(), vector.column<0>().end(), [](int value){ return value == 0; }));
+    CHECK(std::all_of(vector.column<1>().begin(), vector.column<1>().end(), [](double value){ return value == 0.0; }));
+    TupleVector<int> sized(16);
+    CHECK(std::all_of(sized.column<0>().begin(), sized.column<0>().end(), [](int value){ return value == 0; }));
+    ChunkedTupleVector<4, int, double> chunked;
+    chunked.resize(10);
+    for(std::size_t index = 0; index < chunked.size(); ++index)
+    {
+        CHECK(chunked.at<0>(index) == 0);
+        CHECK(chunked.at<1>(index) == 0.0);
+    }
+}
+
+TEST_CASE("Chunked tuple vector", "[TupleVector]")
+{
+    ChunkedTupleVector<16, uint8_t, Aligned<float, 64>, uint64_t> vector;
+    CHECK(vector.empty());
+    CHECK(vector.blocks() == 0);
+    vector.resize(20);
+    CHECK(vector.size() == 20);
+    CHECK(vector.capacity() == 32);
+    CHECK(vector.blocks() == 2);
+    CHECK(vector.blockRows(0) == 16);
+    CHECK(vector.blockRows(1) == 4);
+    for(std::size_t index = 0; index < vector.size(); ++index)
+    {
+        vector.set<0>(index, static_cast<uint8_t>(index));
+        vector.set<1>(index, index / 2.f);
+        vector.set<2>(index, index * 3);
+    }
+    const float* firstBlock = vector.blockColumn<1>(0);
+
+    // Growing appends blocks: the elements stay where they are.
+    vector.resize(1000);
+    CHECK(vector.capacity() == 1008);
+    CHECK(vector.blockColumn<1>(0) == firstBlock);
+    for(std::size_t index = 20; index < vector.size(); ++index)
+    {
+        vector.set<0>(index, static_cast<uint8_t>(index));
+        vector.set<1>(index, index / 2.f);
+        vector.set<2>(index, index * 3);
+    }
+    std::size_t rows = 0;
+    float sum = 0.f;
+    bool aligned = true;
+    bool matches = true;
+    const auto& constVector = vector;
+    constVector.forEachBlock([&](std::size_t first, std::size_t size, const uint8_t* bytes, const float* floats, const uint64_t* words)
+    {
+        aligned = aligned && reinterpret_cast<std::uintptr_t>(floats) % 64 == 0 && reinterpret_cast<std::uintptr_t>(words) % 8 == 0;
+        for(std::size_t index = 0; index < size; ++index)
+        {
+            matches = matches && bytes[index] == static_cast<uint8_t>(first + index) && words[index] == (first + index) * 3;
+            sum += floats[index];
+        }
+        rows += size;
+    });
+    CHECK(rows == 1000);
+    CHECK(aligned);
+    CHECK(matches);
+    CHECK(sum == 999 * 1000 / 4.f);
+    vector.forEachBlock([](std::size_t, std::size_t size, uint8_t*, float* floats, uint64_t*)
+    {
+        for(std::size_t index = 0; index < size; ++index)
+        {
+            floats[index] *= 2.f;
+        }
+    });
+    CHECK(vector.at<1>(999) == 999.f);
+
+    const auto copy = vector;
+    CHECK(copy.size() == 1000);
+    CHECK(copy.at<0>(517) == static_cast<uint8_t>(517));
+    CHECK(copy.at<1>(517) == 517.f);
+    CHECK(copy.at<2>(517) == 517 * 3);
+    vector.clear();
+    CHECK(vector.empty());
+    CHECK(vector.capacity() == 0);
+    CHECK(copy.at<2>(999) == 999 * 3);
+}
+
+namespace
+{
+// Counts its live instances, to check that every element constructed is destroyed once.
+struct Counted
+{
+    Counted()
+    {
+        ++alive;
+    }
+    Counted(int value) :
+        value(value)
+    {
+        ++alive;
+    }
+    Counted(const Counted& other) :
+        value(other.value)
+    {
+        ++alive;
+    }
+    Counted& operator=(const Counted&) = default;
+    ~Counted()
+    {
+        --alive;
+    }
+    int value = 0;
+    static int alive;
+};
+int Counted::alive = 0;
+
+// Its move constructor may throw, so growing must copy it.
+struct ThrowingMove
+{
+    ThrowingMove() = default;
+    ThrowingMove(const ThrowingMove&) = default;
+    ThrowingMove(ThrowingMove&& other) noexcept(false) :
+        value(other.value)
+    {
+        ++moves;
+    }
+    ThrowingMove& operator=(const ThrowingMove&) = default;
+    int value = 0;
+    static int moves;
+};
+int ThrowingMove::moves = 0;
+}
+
+TEST_CASE("Non-trivial elements", "[TupleVector]")
+{
+    {
+        TupleVector<std::string, int, Counted, std::vector<int>> vector;
+        for(int index = 0; index < 100; ++index)
+        {
+            vector.emplace_back(std::string(20, 'a' + index % 26), index, index, std::vector<int>(index, index));
+        }
+        CHECK(vector.size() == 100);
+        CHECK(vector.capacity() == 128);
+        CHECK(Counted::alive == 100);
+        CHECK(vector.at<0>(30) == std::string(20, 'e'));
+        CHECK(vector.at<2>(99).value == 99);
+        CHECK(vector.at<3>(99).size() == 99);
+
+        vector.resize(110);
+        CHECK(Counted::alive == 110);
+        CHECK(vector.at<0>(105).empty());
+        CHECK(vector.at<3>(105).empty());
+        vector.resize(50);
+        CHECK(Counted::alive == 50);
+        vector.emplace_back();
+        CHECK(vector.size() == 51);
+        CHECK(vector.at<2>(50).value == 0);
+
+        const auto copy = vector;
+        CHECK(Counted::alive == 102);
+        CHECK(copy.at<0>(30) == vector.at<0>(30));
+        CHECK(copy.at<3>(49) == std::vector<int>(49, 49));
+        vector.set<0>(30, "changed");
+        CHECK(copy.at<0>(30) == std::string(20, 'e'));
+        vector.clear();
+        CHECK(Counted::alive == 51);
+    }
+    CHECK(Counted::alive == 0);
+    {
+        ChunkedTupleVector<8, std::string, Counted> vector(20);
+        CHECK(Counted::alive == 20);
+        vector.set<0>(19, std::string(100, 'x'));
+        const auto copy = vector;
+        CHECK(Counted::alive == 40);
+        vector.resize(3);
+        CHECK(Counted::alive == 23);
+        CHECK(copy.at<0>(19) == std::string(100, 'x'));
+    }
+    CHECK(Counted::alive == 0);
+}
+
+TEST_CASE("Row operations", "[TupleVector]")
+{
+    TupleVector<std::string, double> vector;
+    vector.emplace_back("a", 1.);
+    vector.emplace_back("b", 2.);
+    vector.emplace_back("c", 3.);
+    vector.emplace_back("d", 4.);
+
+    vector.swapRows(0, 3);
+    CHECK(vector.at<0>(0) == "d");
+    CHECK(vector.at<1>(0) == 4.);
+    CHECK(vector.at<0>(3) == "a");
+    CHECK(vector.at<1>(3) == 1.);
+
+    // The last row takes the place of the erased one.
+    vector.eraseRow(1);
+    CHECK(vector.size() == 3);
+    CHECK(vector.at<0>(1) == "a");
+    CHECK(vector.at<1>(1) == 1.);
+    CHECK(vector.at<0>(2) == "c");
+    vector.eraseRow(2);
+    CHECK(vector.size() == 2);
+    CHECK(vector.at<0>(0) == "d");
+    CHECK(vector.at<0>(1) == "a");
+    vector.eraseRow(0);
+    vector.eraseRow(0);
+    CHECK(vector.empty());
+}
+
+TEST_CASE("Growing", "[TupleVector]")
+{
+    // The arguments refer to the first row, which moves to the new buffer when it grows.
+    TupleVector<std::string, int> vector;
+    vector.emplace_back(std::string(100, 'x'), 7);
+    for(int index = 0; index < 20; ++index)
+    {
+        CHECK((vector.size() == vector.capacity()) == (index == 0 || index == 1 || index == 3 || index == 7 || index == 15));
+        vector.emplace_back(vector.at<0>(0), vector.at<1>(0));
+    }
+    CHECK(vector.size() == 21);
+    CHECK(std::all_of(vector.column<0>().begin(), vector.column<0>().end(), [](const std::string& value){ return value == std::string(100, 'x'); }));
+    CHECK(std::all_of(vector.column<1>().begin(), vector.column<1>().end(), [](int value){ return value == 7; }));
+
+    TupleVector<ThrowingMove, std::string> copied;
+    copied.emplace_back();
+    copied.at<0>(0).value = 3;
+    copied.at<1>(0) = "kept";
+    copied.reserve(16);
+    CHECK(ThrowingMove::moves == 0);
+    CHECK(copied.at<0>(0).value == 3);
+    CHECK(copied.at<1>(0) == "kept");
+}
+
+TEST_CASE("Columns and rows", "[TupleVector]")
+{
+    TupleVector<int, std::string, Aligned<float, 32>> vector;
+    for(int index = 0; index < 10; ++index)
+    {
+        vector.emplace_back(index, std::to_string(index), 0.f);
+    }
+    auto ints = vector.column<0>();
+    CHECK(ranges::distance(ints) == 10);
+    CHECK(std::accumulate(ints.begin(), ints.end(), 0) == 45);
+    CHECK(reinterpret_cast<std::uintptr_t>(&*vector.column<2>().begin()) % 32 == 0);
+    ranges::fill(vector.column<2>(), 1.5f);
+    CHECK(vector.at<2>(9) == 1.5f);
+
+    vector.at<0>(3) = 30;
+    vector.at<1>(3) += "0";
+    CHECK(vector.at<1>(3) == "30");
+
+    ranges::for_each(vector.rows(), [](auto row)
+    {
+        std::get<2>(row) += std::get<0>(row);
+    });
+    CHECK(vector.at<2>(3) == 31.5f);
+    CHECK(vector.at<2>(9) == 10.5f);
+
+    // Rows are random access, so the standard algorithms can sort them by a column.
+    auto rows = vector.rows();
+    std::reverse(rows.begin(), rows.end());
+    CHECK(vector.at<0>(0) == 9);
+    CHECK(vector.at<1>(0) == "9");
+    CHECK(vector.at<0>(6) == 30);
+    CHECK(vector.at<1>(6) == "30");
+    CHECK(rows.end() - rows.begin() == 10);
+    CHECK(std::get<0>(rows.begin()[9]) == 0);
+    std::sort(rows.begin(), rows.end(), [](const auto& first, const auto& second)
+    {
+        return std::get<1>(first) < std::get<1>(second);
+    });
+    CHECK(vector.at<1>(0) == "0");
+    CHECK(vector.at<1>(3) == "30");
+    CHECK(vector.at<0>(3) == 30);
+    CHECK(vector.at<2>(3) == 31.5f);
+    CHECK(vector.at<1>(9) == "9");
+    CHECK(vector.at<2>(9) == 10.5f);
+
+    const auto& constVector = vector;
+    std::vector<std::string> names;
+    for(auto row : constVector.rows())
+    {
+        names.push_back(std::get<1>(row));
+    }
+    CHECK(names.front() == "0");
+    CHECK(names.back() == "9");
+    CHECK(ranges::count(constVector.column<0>(), 30) == 1);
+}
@@ -0,0 +1,116 @@
+#include <catch.hpp>
+#include <Entity/Core/World.hpp>
+#include "test.hpp"
+
+using namespace Entity;
+
+namespace
+{
+struct Position
+{
+    double x, y;
+};
+struct Velocity
+{
+    double x, y;
+};
+}
+
+TEST_CASE("World add", "[World]")
+{
+    World<Test::TestEntity, Position, Velocity> world;
+    CHECK(world.empty());
+    auto en0 = world.add();
+    auto en1 = world.add(Position{1.0, 2.0}, Velocity{3.0, 4.0});
+    CHECK(world.size() == 2);
+    CHECK(world.alive(en0));
+    CHECK(world.alive(en1));
+    CHECK(world.column<Position>().size() == 2);
+    CHECK(world.column<1>().size() == 2);
+    CHECK(world.get<Position>(en0).x == 0.0);
+    CHECK(world.get<Position>(en1).y == 2.0);
+    CHECK(world.get<1>(en1).x == 3.0);
+    world.get<Velocity>(en0) = {5.0, 6.0};
+    CHECK(world.get<1>(en0).y == 6.0);
+}
+
+TEST_CASE("World erase", "[World]")
+{
+    World<Test::TestEntity, Position, int> world;
+    auto en0 = world.add(Position{0.0, 0.0}, 0);
+    auto en1 = world.add(Position{1.0, 1.0}, 1);
+    auto en2 = world.add(Position{2.0, 2.0}, 2);
+    world.erase(en0);
+    CHECK(world.size() == 2);
+    CHECK(!world.alive(en0));
+    CHECK(world.alive(en1));
+    CHECK(world.alive(en2));
+    CHECK(world.column<int>().size() == 2);
+    CHECK(world.get<int>(en1) == 1);
+    CHECK(world.get<int>(en2) == 2);
+    CHECK(world.get<Position>(en2).x == 2.0);
+    CHECK(ranges::count(world.asRange(), en0) == 0);
+}
+
+TEST_CASE("World reserve", "[World]")
+{
+    World<Test::TestEntity, Position> world;
+    world.reserve(128);
+    CHECK(world.capacity() == 128);
+    CHECK(world.column<Position>().capacity() == 128);
+}
+
+TEST_CASE("World with optional columns", "[World]")
+{
+    World<Test::TestEntity, Position> world;
+    auto en0 = world.add(Position{0.0, 0.0});
+    auto name = makeProperty<std::string>(world);
+    CHECK(name.size() == 1);
+    auto en1 = world.add(Position{1.0, 1.0});
+    auto en2 = world.add(Position{2.0, 2.0});
+    name[en0] = "zero";
+    name[en1] = "one";
+    name[en2] = "two";
+    world.erase(en1);
+    CHECK(name.size() == 2);
+    CHECK(name[en0] == "zero");
+    CHECK(name[en2] == "two");
+    CHECK(world.get<Position>(en2).x == 2.0);
+}
+
+TEST_CASE("World notifies only its listeners", "[World]")
+{
+    World<Test::TestEntity, Position> world;
+    auto en0 = world.add(Position{0.0, 0.0});
+    {
+        auto name = makeProperty<std::string>(world);
+        name[en0] = "zero";
+        auto en1 = world.add(Position{1.0, 1.0});
+        name[en1] = "one";
+        world.erase(en0);
+        CHECK(name.size() == 1);
+        CHECK(name[en1] == "one");
+    }
+    // The optional column is gone, so the world goes on without notifying.
+    auto en2 = world.add(Position{2.0, 2.0});
+    auto en3 = world.add(Position{3.0, 3.0});
+    world.erase(en2);
+    CHECK(world.size() == 2);
+    CHECK(world.get<Position>(en3).x == 3.0);
+
+    std::size_t added = 0;
+    std::size_t erased = 0;
+    boost::signals2::scoped_connection onAdd = world.notifier->onAdd.connect([&](Test::TestEntity){ ++added; });
+    boost::signals2::scoped_connection onErase = world.notifier->onErase.connect([&](Test::TestEntity){ ++erased; });
+    auto id = makeProperty<std::size_t>(world);
+    CHECK(id.size() == 2);
+    auto en4 = world.add(Position{4.0, 4.0});
+    id[en3] = 3;
+    id[en4] = 4;
+    world.erase(en3);
+    CHECK(added == 1);
+    CHECK(erased == 1);
+    CHECK(id.size() == 2);
+    CHECK(id[en4] == 4);
+    CHECK(world.get<Position>(en4).x == 4.0);
+}